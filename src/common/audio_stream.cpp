@@ -1,6 +1,7 @@
 #include "audio_stream.h"
 #include "assert.h"
 #include <algorithm>
+#include <cmath>
 #include <cstring>
 
 AudioStream::AudioStream() = default;
@@ -16,16 +17,19 @@ bool AudioStream::Reconfigure(u32 output_sample_rate /*= DefaultOutputSampleRate
   m_output_sample_rate = output_sample_rate;
   m_channels = channels;
   m_buffer_size = buffer_size;
-  AllocateBuffers(buffer_count);
+  m_buffer_count = buffer_count;
+  AllocateBuffer();
   m_output_paused = true;
 
   if (!OpenDevice())
   {
-    EmptyBuffers();
-    m_buffers.clear();
+    m_buffer.reset();
+    m_buffer_frames = 0;
     m_buffer_size = 0;
+    m_buffer_count = 0;
     m_output_sample_rate = 0;
     m_channels = 0;
+    ResetPositions();
     return false;
   }
 
@@ -51,183 +55,256 @@ void AudioStream::Shutdown()
     return;
 
   CloseDevice();
-  EmptyBuffers();
-  m_buffers.clear();
+  m_buffer.reset();
+  m_buffer_frames = 0;
   m_buffer_size = 0;
+  m_buffer_count = 0;
   m_output_sample_rate = 0;
   m_channels = 0;
   m_output_paused = true;
+  ResetPositions();
+}
+
+u32 AudioStream::GetFramesAvailable(u32 read_position, u32 write_position) const
+{
+  return (write_position >= read_position) ? (write_position - read_position) :
+                                             (m_buffer_frames - read_position + write_position);
 }
 
-void AudioStream::BeginWrite(SampleType** buffer_ptr, u32* num_frames)
+u32 AudioStream::GetFramesFree(u32 read_position, u32 write_position) const
 {
-  m_buffer_mutex.lock();
+  return m_buffer_frames - GetFramesAvailable(read_position, write_position) - 1;
+}
 
-  EnsureBuffer();
+void AudioStream::SetDynamicRateControl(bool enable)
+{
+  if (m_dynamic_rate_control == enable)
+    return;
 
-  Buffer& buffer = m_buffers[m_first_free_buffer];
-  *buffer_ptr = buffer.data.data() + (buffer.write_position * m_channels);
-  *num_frames = m_buffer_size - buffer.write_position;
+  m_dynamic_rate_control = enable;
+  ResetResampler();
 }
 
 void AudioStream::WriteFrames(const SampleType* frames, u32 num_frames)
 {
-  u32 remaining_frames = num_frames;
-  std::unique_lock<std::mutex> lock(m_buffer_mutex);
+  if (m_buffer_frames == 0)
+    return;
 
-  while (remaining_frames > 0)
+  if (m_dynamic_rate_control && m_channels <= MAX_RESAMPLE_CHANNELS)
+    ResampleFrames(frames, num_frames);
+  else
+    PushFrames(frames, num_frames);
+}
+
+void AudioStream::ResetResampler()
+{
+  std::memset(m_resample_history, 0, sizeof(m_resample_history));
+  m_resample_position = 0.0;
+}
+
+void AudioStream::ResampleFrames(const SampleType* frames, u32 num_frames)
+{
+  // Adjust the rate based on how full the ring is. Below half full we produce slightly more frames than we're given,
+  // above half full slightly fewer, so the fill level settles around the middle instead of under/overflowing.
+  const double fill = static_cast<double>(GetFramesAvailable(m_read_position.load(std::memory_order_acquire),
+                                                             m_write_position.load(std::memory_order_relaxed))) /
+                      static_cast<double>(m_buffer_frames - 1);
+  const double ratio = 1.0 + DRC_MAX_RATE_DELTA * (1.0 - 2.0 * std::clamp(fill, 0.0, 1.0));
+  const double step = 1.0 / ratio;
+
+  const u32 channels = m_channels;
+  const u32 max_output_frames = static_cast<u32>(std::ceil(static_cast<double>(num_frames) * ratio)) + 1;
+  m_resample_buffer.resize(max_output_frames * channels);
+  SampleType* out = m_resample_buffer.data();
+  u32 output_frames = 0;
+
+  for (u32 i = 0; i < num_frames; i++)
   {
-    EnsureBuffer();
+    // shift the new frame into the history
+    for (u32 c = 0; c < channels; c++)
+    {
+      m_resample_history[0][c] = m_resample_history[1][c];
+      m_resample_history[1][c] = m_resample_history[2][c];
+      m_resample_history[2][c] = m_resample_history[3][c];
+      m_resample_history[3][c] = static_cast<float>(frames[i * channels + c]);
+    }
 
-    Buffer& buffer = m_buffers[m_first_free_buffer];
-    const u32 to_this_buffer = std::min(m_buffer_size - buffer.write_position, remaining_frames);
+    // Catmull-Rom interpolation between history[1] and history[2]. The channels are independent, so the inner loop
+    // is straight-line arithmetic which the compiler can vectorize.
+    while (m_resample_position < 1.0 && output_frames < max_output_frames)
+    {
+      const float t = static_cast<float>(m_resample_position);
+      for (u32 c = 0; c < channels; c++)
+      {
+        const float p0 = m_resample_history[0][c];
+        const float p1 = m_resample_history[1][c];
+        const float p2 = m_resample_history[2][c];
+        const float p3 = m_resample_history[3][c];
+        const float value =
+          p1 + 0.5f * t *
+                 ((p2 - p0) + t * ((2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) + t * (3.0f * (p1 - p2) + p3 - p0)));
+        *(out++) = static_cast<SampleType>(std::clamp(std::lround(value), -32768L, 32767L));
+      }
+
+      output_frames++;
+      m_resample_position += step;
+    }
 
-    const u32 copy_count = to_this_buffer * m_channels;
-    std::memcpy(&buffer.data[buffer.write_position * m_channels], frames, copy_count * sizeof(SampleType));
-    frames += copy_count;
+    m_resample_position -= 1.0;
+  }
 
-    remaining_frames -= to_this_buffer;
-    buffer.write_position += to_this_buffer;
+  PushFrames(m_resample_buffer.data(), output_frames);
+}
 
-    // End of the buffer?
-    if (buffer.write_position == m_buffer_size)
+void AudioStream::PushFrames(const SampleType* frames, u32 num_frames)
+{
+  u32 remaining_frames = num_frames;
+  while (remaining_frames > 0)
+  {
+    const u32 read_position = m_read_position.load(std::memory_order_acquire);
+    u32 write_position = m_write_position.load(std::memory_order_relaxed);
+    u32 free_frames = GetFramesFree(read_position, write_position);
+    if (free_frames == 0)
     {
-      // Reset it back to the start, and enqueue it.
-      buffer.write_position = 0;
-      m_num_free_buffers--;
-      m_first_free_buffer = (m_first_free_buffer + 1) % m_buffers.size();
-      m_num_available_buffers++;
-      BufferAvailable();
+      if (!m_sync)
+      {
+        // Out of space, and we're running faster than the output. Drop what doesn't fit.
+        FramesAvailable();
+        return;
+      }
+
+      WaitForSpace();
+      continue;
     }
+
+    // Copy up to the end of the ring, then wrap around.
+    const u32 frames_to_copy = std::min(std::min(free_frames, remaining_frames), m_buffer_frames - write_position);
+    const u32 copy_count = frames_to_copy * m_channels;
+    std::memcpy(&m_buffer[write_position * m_channels], frames, copy_count * sizeof(SampleType));
+    frames += copy_count;
+    remaining_frames -= frames_to_copy;
+
+    write_position = (write_position + frames_to_copy) % m_buffer_frames;
+    m_frames_written += frames_to_copy;
+    m_write_position.store(write_position, std::memory_order_release);
   }
+
+  FramesAvailable();
 }
 
-void AudioStream::EndWrite(u32 num_frames)
+void AudioStream::WaitForSpace()
 {
-  Buffer& buffer = m_buffers[m_first_free_buffer];
-  DebugAssert((buffer.write_position + num_frames) <= m_buffer_size);
-  buffer.write_position += num_frames;
+  // The waiting flag is set before the read position is checked, and the consumer stores the read position before
+  // checking the flag. Either we see the new position, or the consumer sees the flag and notifies under the lock,
+  // which it can't take until we're waiting.
+  std::unique_lock<std::mutex> lock(m_space_mutex);
+  m_space_waiting.store(true);
+  m_space_available_cv.wait(lock, [this]() {
+    return !m_sync || GetFramesFree(m_read_position.load(), m_write_position.load(std::memory_order_relaxed)) > 0;
+  });
+  m_space_waiting.store(false, std::memory_order_relaxed);
+}
 
-  // End of the buffer?
-  if (buffer.write_position == m_buffer_size)
-  {
-    // Reset it back to the start, and enqueue it.
-    // Log_DevPrintf("Enqueue buffer %u", m_first_free_buffer);
-    buffer.write_position = 0;
-    m_num_free_buffers--;
-    m_first_free_buffer = (m_first_free_buffer + 1) % m_buffers.size();
-    m_num_available_buffers++;
-    BufferAvailable();
-  }
+void AudioStream::NotifySpaceAvailable()
+{
+  if (!m_space_waiting.load())
+    return;
 
-  m_buffer_mutex.unlock();
+  std::unique_lock<std::mutex> lock(m_space_mutex);
+  m_space_available_cv.notify_one();
 }
 
 u32 AudioStream::GetSamplesAvailable() const
 {
-  // TODO: Use atomic loads
-  u32 available_buffers;
-  {
-    std::unique_lock<std::mutex> lock(m_buffer_mutex);
-    available_buffers = m_num_available_buffers;
-  }
-
-  return available_buffers * m_buffer_size;
+  return GetFramesAvailable(m_read_position.load(std::memory_order_relaxed),
+                            m_write_position.load(std::memory_order_acquire));
 }
 
 u32 AudioStream::ReadSamples(SampleType* samples, u32 num_samples)
 {
-  u32 remaining_samples = num_samples;
-  std::unique_lock<std::mutex> lock(m_buffer_mutex);
-
-  while (remaining_samples > 0 && m_num_available_buffers > 0)
+  if (m_buffer_frames == 0)
+    return 0;
+
+  // Check for a discard before loading the write position, so everything written before the discard point is
+  // visible. We may already have read past it, if it was requested after the last check.
+  u32 read_position = m_read_position.load(std::memory_order_relaxed);
+  const u64 empty_request = m_empty_request.exchange(0, std::memory_order_acq_rel);
+  const u32 write_position = m_write_position.load(std::memory_order_acquire);
+  if (empty_request != 0)
   {
-    Buffer& buffer = m_buffers[m_first_available_buffer];
-    const u32 from_this_buffer = std::min(m_buffer_size - buffer.read_position, remaining_samples);
-
-    const u32 copy_count = from_this_buffer * m_channels;
-    std::memcpy(samples, &buffer.data[buffer.read_position * m_channels], copy_count * sizeof(SampleType));
-    samples += copy_count;
-
-    remaining_samples -= from_this_buffer;
-    buffer.read_position += from_this_buffer;
-
-    if (buffer.read_position == m_buffer_size)
+    const s32 frames_to_discard = static_cast<s32>(static_cast<u32>(empty_request) - m_frames_read);
+    if (frames_to_discard > 0)
     {
-      // Log_DevPrintf("Finish dequeing buffer %u", m_first_available_buffer);
-      // End of this buffer.
-      buffer.read_position = 0;
-      m_num_available_buffers--;
-      m_first_available_buffer = (m_first_available_buffer + 1) % m_buffers.size();
-      m_num_free_buffers++;
-      m_buffer_available_cv.notify_one();
+      read_position = (read_position + static_cast<u32>(frames_to_discard)) % m_buffer_frames;
+      m_frames_read += static_cast<u32>(frames_to_discard);
+      m_read_position.store(read_position);
+      NotifySpaceAvailable();
     }
   }
 
-  return num_samples - remaining_samples;
-}
+  const u32 frames_to_read = std::min(GetFramesAvailable(read_position, write_position), num_samples);
+  u32 remaining_frames = frames_to_read;
+  while (remaining_frames > 0)
+  {
+    const u32 frames_to_copy = std::min(remaining_frames, m_buffer_frames - read_position);
+    const u32 copy_count = frames_to_copy * m_channels;
+    std::memcpy(samples, &m_buffer[read_position * m_channels], copy_count * sizeof(SampleType));
+    samples += copy_count;
+    remaining_frames -= frames_to_copy;
+    read_position = (read_position + frames_to_copy) % m_buffer_frames;
+  }
 
-void AudioStream::AllocateBuffers(u32 buffer_count)
-{
-  m_buffers.resize(buffer_count);
-  for (u32 i = 0; i < buffer_count; i++)
+  if (frames_to_read > 0)
   {
-    Buffer& buffer = m_buffers[i];
-    buffer.data.resize(m_buffer_size * m_channels);
-    buffer.read_position = 0;
-    buffer.write_position = 0;
+    m_frames_read += frames_to_read;
+    m_read_position.store(read_position);
+    NotifySpaceAvailable();
   }
 
-  m_first_available_buffer = 0;
-  m_num_available_buffers = 0;
-  m_first_free_buffer = 0;
-  m_num_free_buffers = buffer_count;
+  return frames_to_read;
 }
 
-void AudioStream::EnsureBuffer()
+void AudioStream::DropFrames(u32 num_frames)
 {
-  if (m_num_free_buffers > 0)
-    return;
-
-  if (m_sync)
-  {
-    std::unique_lock<std::mutex> lock(m_buffer_mutex, std::adopt_lock);
-    m_buffer_available_cv.wait(lock, [this]() { return m_num_free_buffers > 0; });
-    lock.release();
-  }
-  else
-  {
-    DropBuffer();
-  }
+  const u32 write_position = m_write_position.load(std::memory_order_acquire);
+  const u32 read_position = m_read_position.load(std::memory_order_relaxed);
+  const u32 frames_to_drop = std::min(GetFramesAvailable(read_position, write_position), num_frames);
+  m_frames_read += frames_to_drop;
+  m_read_position.store((read_position + frames_to_drop) % m_buffer_frames);
+  NotifySpaceAvailable();
 }
 
-void AudioStream::DropBuffer()
+void AudioStream::AllocateBuffer()
 {
-  DebugAssert(m_num_available_buffers > 0);
-  // Log_DevPrintf("Dropping buffer %u", m_first_free_buffer);
-
-  // Out of space. We'll overwrite the oldest buffer with the new data.
-  // At the same time, we shift the available buffer forward one.
-  m_first_available_buffer = (m_first_available_buffer + 1) % m_buffers.size();
-  m_num_available_buffers--;
+  m_buffer_frames = (m_buffer_size * m_buffer_count) + 1;
+  m_buffer = std::make_unique<SampleType[]>(m_buffer_frames * m_channels);
+  ResetPositions();
+}
 
-  m_buffers[m_first_free_buffer].read_position = 0;
-  m_buffers[m_first_free_buffer].write_position = 0;
-  m_num_free_buffers++;
+void AudioStream::ResetPositions()
+{
+  m_read_position.store(0, std::memory_order_relaxed);
+  m_write_position.store(0, std::memory_order_relaxed);
+  m_frames_written = 0;
+  m_frames_read = 0;
+  m_empty_request.store(0, std::memory_order_relaxed);
 }
 
 void AudioStream::EmptyBuffers()
 {
-  std::unique_lock<std::mutex> lock(m_buffer_mutex);
+  // Don't interpolate the next frames from the ones being discarded.
+  ResetResampler();
 
-  for (Buffer& buffer : m_buffers)
+  if (m_output_paused)
   {
-    buffer.read_position = 0;
-    buffer.write_position = 0;
+    // The device isn't pulling frames, so nobody else can be touching the positions.
+    m_read_position.store(m_write_position.load(std::memory_order_relaxed), std::memory_order_release);
+    m_frames_read = m_frames_written;
+    m_empty_request.store(0, std::memory_order_relaxed);
+    return;
   }
 
-  m_first_free_buffer = 0;
-  m_num_free_buffers = static_cast<u32>(m_buffers.size());
-  m_first_available_buffer = 0;
-  m_num_available_buffers = 0;
+  // Only the consumer can move the read position, so have it discard what has been written so far on its next read.
+  // Anything written after this is still played.
+  m_empty_request.store(EMPTY_REQUEST_FLAG | m_frames_written, std::memory_order_release);
 }
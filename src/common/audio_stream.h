@@ -1,5 +1,6 @@
 #pragma once
 #include "types.h"
+#include <atomic>
 #include <condition_variable>
 #include <memory>
 #include <mutex>
@@ -25,21 +26,26 @@ public:
   u32 GetOutputSampleRate() const { return m_output_sample_rate; }
   u32 GetChannels() const { return m_channels; }
   u32 GetBufferSize() const { return m_buffer_size; }
-  u32 GetBufferCount() const { return static_cast<u32>(m_buffers.size()); }
+  u32 GetBufferCount() const { return m_buffer_count; }
   bool IsSyncing() const { return m_sync; }
+  bool IsDynamicRateControlEnabled() const { return m_dynamic_rate_control; }
 
   bool Reconfigure(u32 output_sample_rate = DefaultOutputSampleRate, u32 channels = 1,
                    u32 buffer_size = DefaultBufferSize, u32 buffer_count = DefaultBufferCount);
   void SetSync(bool enable) { m_sync = enable; }
 
+  /// Enables resampling of written frames, adjusting the rate slightly to keep the ring half full.
+  void SetDynamicRateControl(bool enable);
+
   void PauseOutput(bool paused);
+
+  /// Discards the frames which have been written so far. Must be called from the thread which writes frames.
   void EmptyBuffers();
 
   void Shutdown();
 
-  void BeginWrite(SampleType** buffer_ptr, u32* num_frames);
+  /// Writes frames to the ring. If the ring is full, blocks when syncing, otherwise drops the frames which don't fit.
   void WriteFrames(const SampleType* frames, u32 num_frames);
-  void EndWrite(u32 num_frames);
 
   static std::unique_ptr<AudioStream> CreateNullAudioStream();
 
@@ -49,44 +55,67 @@ protected:
   virtual bool OpenDevice() = 0;
   virtual void PauseDevice(bool paused) = 0;
   virtual void CloseDevice() = 0;
-  virtual void BufferAvailable() = 0;
+  virtual void FramesAvailable() = 0;
 
   bool IsDeviceOpen() const { return (m_output_sample_rate > 0); }
 
+  // Consumer side, called from the device's callback thread. Never blocks.
   u32 GetSamplesAvailable() const;
   u32 ReadSamples(SampleType* samples, u32 num_samples);
-
-  void DropBuffer();
+  void DropFrames(u32 num_frames);
 
   u32 m_output_sample_rate = 0;
   u32 m_channels = 0;
   u32 m_buffer_size = 0;
+  u32 m_buffer_count = 0;
 
 private:
-  struct Buffer
-  {
-    std::vector<SampleType> data;
-    u32 write_position;
-    u32 read_position;
-  };
-
-  void AllocateBuffers(u32 buffer_count);
-  void EnsureBuffer();
-
-  std::vector<Buffer> m_buffers;
-  mutable std::mutex m_buffer_mutex;
-
-  // For input.
-  u32 m_first_free_buffer = 0;
-  u32 m_num_free_buffers = 0;
-
-  // For output.
-  u32 m_num_available_buffers = 0;
-  u32 m_first_available_buffer = 0;
-
-  // TODO: Switch to semaphore
-  std::condition_variable m_buffer_available_cv;
+  // Maximum deviation from the nominal rate. 0.5% is below what is audible as a pitch change.
+  static constexpr double DRC_MAX_RATE_DELTA = 0.005;
+  static constexpr u32 MAX_RESAMPLE_CHANNELS = 2;
+  static constexpr u32 RESAMPLE_HISTORY_FRAMES = 4;
+
+  void PushFrames(const SampleType* frames, u32 num_frames);
+  void ResampleFrames(const SampleType* frames, u32 num_frames);
+  void ResetResampler();
+  void AllocateBuffer();
+  void ResetPositions();
+  u32 GetFramesAvailable(u32 read_position, u32 write_position) const;
+  u32 GetFramesFree(u32 read_position, u32 write_position) const;
+  void WaitForSpace();
+  void NotifySpaceAvailable();
+
+  // Single-producer/single-consumer ring of frames. One frame is always left empty, so that a full ring can be
+  // distinguished from an empty ring. The emulation thread only writes m_write_position, and the device's callback
+  // thread only writes m_read_position.
+  std::unique_ptr<SampleType[]> m_buffer;
+  u32 m_buffer_frames = 0;
+  std::atomic<u32> m_read_position{0};
+  std::atomic<u32> m_write_position{0};
+
+  // Frames written and read since the positions were reset, wrapping. Unlike the ring positions, these tell whether
+  // the consumer has already read past a point. Each is only touched by its own side, except while output is paused.
+  u32 m_frames_written = 0;
+  u32 m_frames_read = 0;
+
+  // Set by EmptyBuffers() to EMPTY_REQUEST_FLAG | m_frames_written, to have the consumer discard everything written
+  // before the call. Frames written afterwards are kept.
+  static constexpr u64 EMPTY_REQUEST_FLAG = UINT64_C(1) << 32;
+  std::atomic<u64> m_empty_request{0};
+
+  // Only used to block the producer when syncing and the ring is full. The consumer only takes the lock to notify
+  // while the producer is waiting, so the callback doesn't block otherwise.
+  std::mutex m_space_mutex;
+  std::condition_variable m_space_available_cv;
+  std::atomic_bool m_space_waiting{false};
 
   bool m_output_paused = true;
-  bool m_sync = true;
-};
\ No newline at end of file
+  std::atomic_bool m_sync{true};
+
+  // Cubic resampler state for dynamic rate control. The history holds the last four input frames per channel,
+  // and output frames are interpolated between the middle two, at m_resample_position.
+  bool m_dynamic_rate_control = false;
+  float m_resample_history[RESAMPLE_HISTORY_FRAMES][MAX_RESAMPLE_CHANNELS] = {};
+  double m_resample_position = 0.0;
+  std::vector<SampleType> m_resample_buffer;
+};
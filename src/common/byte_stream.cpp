@@ -7,6 +7,11 @@
 #include <cstdlib>
 #include <cstring>
 #include <sys/stat.h>
+#include <vector>
+#include <zlib.h>
+#include "Alloc.h"
+#include "LzmaDec.h"
+#include "LzmaEnc.h"
 #if defined(WIN32)
 #include "windows_headers.h"
 #include <direct.h>
@@ -1222,6 +1227,385 @@ std::unique_ptr<ByteStream> ByteStream_OpenFileStream(const char* fileName, u32
 
 #endif
 
+// base class for the compression streams, which can only be read or written sequentially.
+class SequentialByteStream : public ByteStream
+{
+public:
+  virtual bool ReadByte(u8* pDestByte) override { return Read2(pDestByte, 1, nullptr); }
+
+  virtual u32 Read(void* pDestination, u32 ByteCount) override
+  {
+    m_errorState = true;
+    return 0;
+  }
+
+  virtual bool Read2(void* pDestination, u32 ByteCount, u32* pNumberOfBytesRead /* = nullptr */) override
+  {
+    const u32 bytesRead = Read(pDestination, ByteCount);
+    if (pNumberOfBytesRead != nullptr)
+      *pNumberOfBytesRead = bytesRead;
+
+    if (bytesRead != ByteCount)
+    {
+      m_errorState = true;
+      return false;
+    }
+
+    return true;
+  }
+
+  virtual bool WriteByte(u8 SourceByte) override { return Write2(&SourceByte, 1, nullptr); }
+
+  virtual u32 Write(const void* pSource, u32 ByteCount) override
+  {
+    m_errorState = true;
+    return 0;
+  }
+
+  virtual bool Write2(const void* pSource, u32 ByteCount, u32* pNumberOfBytesWritten /* = nullptr */) override
+  {
+    const u32 bytesWritten = Write(pSource, ByteCount);
+    if (pNumberOfBytesWritten != nullptr)
+      *pNumberOfBytesWritten = bytesWritten;
+
+    if (bytesWritten != ByteCount)
+    {
+      m_errorState = true;
+      return false;
+    }
+
+    return true;
+  }
+
+  virtual bool SeekAbsolute(u64 Offset) override { return false; }
+  virtual bool SeekRelative(s64 Offset) override { return false; }
+  virtual bool SeekToEnd() override { return false; }
+
+  // position and size are in uncompressed bytes.
+  virtual u64 GetPosition() const override { return m_position; }
+  virtual u64 GetSize() const override { return m_position; }
+
+  virtual bool Flush() override { return true; }
+  virtual bool Commit() override { return true; }
+  virtual bool Discard() override { return true; }
+
+protected:
+  enum : u32
+  {
+    BUFFER_SIZE = 65536
+  };
+
+  u64 m_position = 0;
+};
+
+class DeflateCompressByteStream final : public SequentialByteStream
+{
+public:
+  DeflateCompressByteStream(ByteStream* pDestinationStream)
+    : m_pDestinationStream(pDestinationStream), m_pBuffer(std::make_unique<u8[]>(BUFFER_SIZE))
+  {
+  }
+
+  virtual ~DeflateCompressByteStream()
+  {
+    if (m_initialized)
+      deflateEnd(&m_stream);
+  }
+
+  bool Initialize(int compressionLevel)
+  {
+    m_initialized = (deflateInit(&m_stream, compressionLevel) == Z_OK);
+    return m_initialized;
+  }
+
+  virtual u32 Write(const void* pSource, u32 ByteCount) override
+  {
+    if (m_errorState || m_finished)
+      return 0;
+
+    m_stream.next_in = static_cast<Bytef*>(const_cast<void*>(pSource));
+    m_stream.avail_in = ByteCount;
+    if (!Deflate(Z_NO_FLUSH))
+      return 0;
+
+    m_position += ByteCount;
+    return ByteCount;
+  }
+
+  // finishes the compressed data, then commits the destination stream.
+  virtual bool Commit() override
+  {
+    if (!m_finished)
+    {
+      if (m_errorState)
+        return false;
+
+      m_stream.avail_in = 0;
+      if (!Deflate(Z_FINISH))
+        return false;
+
+      m_finished = true;
+    }
+
+    return m_pDestinationStream->Commit();
+  }
+
+  virtual bool Discard() override { return m_pDestinationStream->Discard(); }
+
+private:
+  bool Deflate(int flush)
+  {
+    for (;;)
+    {
+      m_stream.next_out = m_pBuffer.get();
+      m_stream.avail_out = BUFFER_SIZE;
+
+      const int result = deflate(&m_stream, flush);
+      if (result == Z_STREAM_ERROR)
+      {
+        Log_ErrorPrintf("deflate() failed");
+        m_errorState = true;
+        return false;
+      }
+
+      const u32 size = BUFFER_SIZE - m_stream.avail_out;
+      if (size > 0 && !m_pDestinationStream->Write2(m_pBuffer.get(), size))
+      {
+        m_errorState = true;
+        return false;
+      }
+
+      // when not finishing, space left over means all the input was consumed.
+      if ((flush == Z_FINISH) ? (result == Z_STREAM_END) : (m_stream.avail_out != 0))
+        return true;
+    }
+  }
+
+  ByteStream* m_pDestinationStream;
+  std::unique_ptr<u8[]> m_pBuffer;
+  z_stream m_stream = {};
+  bool m_initialized = false;
+  bool m_finished = false;
+};
+
+class DeflateDecompressByteStream final : public SequentialByteStream
+{
+public:
+  DeflateDecompressByteStream(ByteStream* pSourceStream)
+    : m_pSourceStream(pSourceStream), m_pBuffer(std::make_unique<u8[]>(BUFFER_SIZE))
+  {
+  }
+
+  virtual ~DeflateDecompressByteStream()
+  {
+    if (m_initialized)
+      inflateEnd(&m_stream);
+  }
+
+  bool Initialize()
+  {
+    m_initialized = (inflateInit(&m_stream) == Z_OK);
+    return m_initialized;
+  }
+
+  virtual u32 Read(void* pDestination, u32 ByteCount) override
+  {
+    if (m_errorState)
+      return 0;
+
+    m_stream.next_out = static_cast<Bytef*>(pDestination);
+    m_stream.avail_out = ByteCount;
+    while (m_stream.avail_out > 0 && !m_finished)
+    {
+      if (m_stream.avail_in == 0)
+      {
+        const u32 bytesRead = m_pSourceStream->Read(m_pBuffer.get(), BUFFER_SIZE);
+        if (bytesRead == 0)
+        {
+          Log_ErrorPrintf("Compressed data is truncated");
+          m_errorState = true;
+          break;
+        }
+
+        m_stream.next_in = m_pBuffer.get();
+        m_stream.avail_in = bytesRead;
+      }
+
+      const int result = inflate(&m_stream, Z_NO_FLUSH);
+      if (result == Z_STREAM_END)
+      {
+        m_finished = true;
+      }
+      else if (result != Z_OK)
+      {
+        Log_ErrorPrintf("inflate() failed: %d", result);
+        m_errorState = true;
+        break;
+      }
+    }
+
+    const u32 bytesRead = ByteCount - m_stream.avail_out;
+    m_position += bytesRead;
+    return bytesRead;
+  }
+
+private:
+  ByteStream* m_pSourceStream;
+  std::unique_ptr<u8[]> m_pBuffer;
+  z_stream m_stream = {};
+  bool m_initialized = false;
+  bool m_finished = false;
+};
+
+// lzma data is written as the encoder properties, followed by the uncompressed size, and the compressed data.
+class LZMACompressByteStream final : public SequentialByteStream
+{
+public:
+  LZMACompressByteStream(ByteStream* pDestinationStream, int compressionLevel)
+    : m_pDestinationStream(pDestinationStream), m_compressionLevel(compressionLevel)
+  {
+  }
+
+  // the encoder pulls its input, so the data is buffered until the stream is committed.
+  virtual u32 Write(const void* pSource, u32 ByteCount) override
+  {
+    if (m_errorState || m_finished)
+      return 0;
+
+    const u8* pSourceBytes = static_cast<const u8*>(pSource);
+    m_data.insert(m_data.end(), pSourceBytes, pSourceBytes + ByteCount);
+    m_position += ByteCount;
+    return ByteCount;
+  }
+
+  // compresses the data, then commits the destination stream.
+  virtual bool Commit() override
+  {
+    if (!m_finished)
+    {
+      if (m_errorState || !Encode())
+      {
+        m_errorState = true;
+        return false;
+      }
+
+      m_finished = true;
+    }
+
+    return m_pDestinationStream->Commit();
+  }
+
+  virtual bool Discard() override { return m_pDestinationStream->Discard(); }
+
+private:
+  bool Encode()
+  {
+    CLzmaEncProps props;
+    LzmaEncProps_Init(&props);
+    props.level = m_compressionLevel;
+    props.reduceSize = m_data.size();
+
+    // worst case is slightly larger than the input.
+    std::vector<u8> compressedData(m_data.size() + (m_data.size() / 3) + 128);
+    SizeT compressedSize = compressedData.size();
+    u8 header[LZMA_PROPS_SIZE + sizeof(u64)];
+    SizeT propsSize = LZMA_PROPS_SIZE;
+    const SRes result = LzmaEncode(compressedData.data(), &compressedSize, m_data.data(), m_data.size(), &props,
+                                   header, &propsSize, 0, nullptr, &g_Alloc, &g_Alloc);
+    if (result != SZ_OK || propsSize != LZMA_PROPS_SIZE)
+    {
+      Log_ErrorPrintf("LzmaEncode() failed: %d", result);
+      return false;
+    }
+
+    const u64 uncompressedSize = m_data.size();
+    std::memcpy(&header[LZMA_PROPS_SIZE], &uncompressedSize, sizeof(uncompressedSize));
+    return (m_pDestinationStream->Write2(header, sizeof(header)) &&
+            m_pDestinationStream->Write2(compressedData.data(), static_cast<u32>(compressedSize)));
+  }
+
+  ByteStream* m_pDestinationStream;
+  int m_compressionLevel;
+  std::vector<u8> m_data;
+  bool m_finished = false;
+};
+
+class LZMADecompressByteStream final : public SequentialByteStream
+{
+public:
+  LZMADecompressByteStream(ByteStream* pSourceStream)
+    : m_pSourceStream(pSourceStream), m_pBuffer(std::make_unique<u8[]>(BUFFER_SIZE))
+  {
+    LzmaDec_Construct(&m_decoder);
+  }
+
+  virtual ~LZMADecompressByteStream() { LzmaDec_Free(&m_decoder, &g_Alloc); }
+
+  bool Initialize()
+  {
+    u8 header[LZMA_PROPS_SIZE + sizeof(u64)];
+    if (!m_pSourceStream->Read2(header, sizeof(header)) ||
+        LzmaDec_Allocate(&m_decoder, header, LZMA_PROPS_SIZE, &g_Alloc) != SZ_OK)
+    {
+      return false;
+    }
+
+    std::memcpy(&m_uncompressedSize, &header[LZMA_PROPS_SIZE], sizeof(m_uncompressedSize));
+    LzmaDec_Init(&m_decoder);
+    return true;
+  }
+
+  virtual u32 Read(void* pDestination, u32 ByteCount) override
+  {
+    if (m_errorState)
+      return 0;
+
+    // there's no end marker, so stop at the uncompressed size.
+    u8* pDestinationBytes = static_cast<u8*>(pDestination);
+    u32 remaining = static_cast<u32>(std::min<u64>(ByteCount, m_uncompressedSize - m_position));
+    while (remaining > 0)
+    {
+      if (m_bufferPosition == m_bufferSize)
+      {
+        m_bufferSize = m_pSourceStream->Read(m_pBuffer.get(), BUFFER_SIZE);
+        m_bufferPosition = 0;
+        if (m_bufferSize == 0)
+        {
+          Log_ErrorPrintf("Compressed data is truncated");
+          m_errorState = true;
+          break;
+        }
+      }
+
+      SizeT outputSize = remaining;
+      SizeT inputSize = m_bufferSize - m_bufferPosition;
+      ELzmaStatus status;
+      const SRes result = LzmaDec_DecodeToBuf(&m_decoder, pDestinationBytes, &outputSize,
+                                              &m_pBuffer[m_bufferPosition], &inputSize, LZMA_FINISH_ANY, &status);
+      m_bufferPosition += static_cast<u32>(inputSize);
+      pDestinationBytes += outputSize;
+      remaining -= static_cast<u32>(outputSize);
+      m_position += outputSize;
+      if (result != SZ_OK || (inputSize == 0 && outputSize == 0))
+      {
+        Log_ErrorPrintf("LzmaDec_DecodeToBuf() failed: %d", result);
+        m_errorState = true;
+        break;
+      }
+    }
+
+    return static_cast<u32>(pDestinationBytes - static_cast<u8*>(pDestination));
+  }
+
+private:
+  ByteStream* m_pSourceStream;
+  std::unique_ptr<u8[]> m_pBuffer;
+  u32 m_bufferPosition = 0;
+  u32 m_bufferSize = 0;
+  u64 m_uncompressedSize = 0;
+  CLzmaDec m_decoder;
+};
+
 std::unique_ptr<MemoryByteStream> ByteStream_CreateMemoryStream(void* pMemory, u32 Size)
 {
   DebugAssert(pMemory != nullptr && Size > 0);
@@ -1249,6 +1633,39 @@ std::unique_ptr<GrowableMemoryByteStream> ByteStream_CreateGrowableMemoryStream(
   return std::make_unique<GrowableMemoryByteStream>(nullptr, 0);
 }
 
+std::unique_ptr<ByteStream> ByteStream_CreateDeflateCompressStream(ByteStream* pDestinationStream,
+                                                                   int CompressionLevel)
+{
+  std::unique_ptr<DeflateCompressByteStream> stream = std::make_unique<DeflateCompressByteStream>(pDestinationStream);
+  if (!stream->Initialize(CompressionLevel))
+    return nullptr;
+
+  return stream;
+}
+
+std::unique_ptr<ByteStream> ByteStream_CreateDeflateDecompressStream(ByteStream* pSourceStream)
+{
+  std::unique_ptr<DeflateDecompressByteStream> stream = std::make_unique<DeflateDecompressByteStream>(pSourceStream);
+  if (!stream->Initialize())
+    return nullptr;
+
+  return stream;
+}
+
+std::unique_ptr<ByteStream> ByteStream_CreateLZMACompressStream(ByteStream* pDestinationStream, int CompressionLevel)
+{
+  return std::make_unique<LZMACompressByteStream>(pDestinationStream, CompressionLevel);
+}
+
+std::unique_ptr<ByteStream> ByteStream_CreateLZMADecompressStream(ByteStream* pSourceStream)
+{
+  std::unique_ptr<LZMADecompressByteStream> stream = std::make_unique<LZMADecompressByteStream>(pSourceStream);
+  if (!stream->Initialize())
+    return nullptr;
+
+  return stream;
+}
+
 bool ByteStream_CopyStream(ByteStream* pDestinationStream, ByteStream* pSourceStream)
 {
   const u32 chunkSize = 4096;
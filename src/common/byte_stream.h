@@ -215,6 +215,16 @@ std::unique_ptr<ReadOnlyMemoryByteStream> ByteStream_CreateReadOnlyMemoryStream(
 // null memory stream
 std::unique_ptr<NullByteStream> ByteStream_CreateNullStream();
 
+// compression streams, using zlib's deflate or lzma. the compressing streams are write-only, and complete the
+// compressed data when committed, before committing the destination stream. the decompressing streams are read-only.
+// neither can seek, and the wrapped stream must outlive them. returns nullptr if the (de)compressor could not be
+// initialized.
+std::unique_ptr<ByteStream> ByteStream_CreateDeflateCompressStream(ByteStream* pDestinationStream,
+                                                                   int CompressionLevel);
+std::unique_ptr<ByteStream> ByteStream_CreateDeflateDecompressStream(ByteStream* pSourceStream);
+std::unique_ptr<ByteStream> ByteStream_CreateLZMACompressStream(ByteStream* pDestinationStream, int CompressionLevel);
+std::unique_ptr<ByteStream> ByteStream_CreateLZMADecompressStream(ByteStream* pSourceStream);
+
 // copies one stream's contents to another. rewinds source streams automatically, and returns it back to its old
 // position.
 bool ByteStream_CopyStream(ByteStream* pDestinationStream, ByteStream* pSourceStream);
@@ -0,0 +1,159 @@
+#include "cd_flac_reader.h"
+#include "file_system.h"
+#include "log.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+Log_SetChannel(CDFLACReader);
+
+CDFLACReader::CDFLACReader() = default;
+
+CDFLACReader::~CDFLACReader()
+{
+  if (m_decoder)
+  {
+    FLAC__stream_decoder_finish(m_decoder);
+    FLAC__stream_decoder_delete(m_decoder);
+  }
+}
+
+bool CDFLACReader::Open(const char* filename)
+{
+  std::FILE* fp = FileSystem::OpenCFile(filename, "rb");
+  if (!fp)
+  {
+    Log_ErrorPrintf("Failed to open '%s'", filename);
+    return false;
+  }
+
+  m_decoder = FLAC__stream_decoder_new();
+  if (!m_decoder)
+  {
+    std::fclose(fp);
+    return false;
+  }
+
+  // The decoder owns the file from here on, even if init fails, and closes it in finish().
+  if (FLAC__stream_decoder_init_FILE(m_decoder, fp, WriteCallback, MetadataCallback, ErrorCallback, this) !=
+      FLAC__STREAM_DECODER_INIT_STATUS_OK)
+  {
+    Log_ErrorPrintf("Failed to initialize FLAC decoder for '%s'", filename);
+    return false;
+  }
+
+  if (!FLAC__stream_decoder_process_until_end_of_metadata(m_decoder))
+  {
+    Log_ErrorPrintf("Failed to read FLAC metadata from '%s'", filename);
+    return false;
+  }
+
+  if (!m_format_supported || m_total_samples == 0)
+  {
+    Log_ErrorPrintf("'%s' is not 16-bit stereo 44100hz audio with a known length", filename);
+    return false;
+  }
+
+  return true;
+}
+
+bool CDFLACReader::Read(u64 offset, void* buffer, u32 size)
+{
+  if ((offset + size) > GetSize())
+    return false;
+
+  const u64 start_sample = offset / BYTES_PER_SAMPLE;
+  const u64 end_sample = (offset + size + BYTES_PER_SAMPLE - 1) / BYTES_PER_SAMPLE;
+  if (!DecodeSamples(start_sample, end_sample))
+    return false;
+
+  const u64 buffer_offset = offset - (m_buffer_start * BYTES_PER_SAMPLE);
+  std::memcpy(buffer, reinterpret_cast<const u8*>(m_buffer.data()) + buffer_offset, size);
+  return true;
+}
+
+bool CDFLACReader::DecodeSamples(u64 start_sample, u64 end_sample)
+{
+  const u64 buffer_end = m_buffer_start + (m_buffer.size() / NUM_CHANNELS);
+  if (start_sample < m_buffer_start || start_sample > (buffer_end + MAX_SKIP_SAMPLES))
+  {
+    // The decoder calls back with the target as the first sample.
+    m_buffer.clear();
+    m_buffer_start = start_sample;
+    if (!FLAC__stream_decoder_seek_absolute(m_decoder, start_sample))
+    {
+      Log_ErrorPrintf("Failed to seek to sample %" PRIu64, start_sample);
+      if (FLAC__stream_decoder_get_state(m_decoder) == FLAC__STREAM_DECODER_SEEK_ERROR)
+        FLAC__stream_decoder_flush(m_decoder);
+
+      return false;
+    }
+  }
+  else if ((start_sample - m_buffer_start) > (HISTORY_SAMPLES + COMPACT_SAMPLES))
+  {
+    // Drop what we've already read, keeping a little history.
+    const u64 drop_samples =
+      std::min<u64>(start_sample - m_buffer_start - HISTORY_SAMPLES, buffer_end - m_buffer_start);
+    m_buffer.erase(m_buffer.begin(), m_buffer.begin() + static_cast<size_t>(drop_samples * NUM_CHANNELS));
+    m_buffer_start += drop_samples;
+  }
+
+  while ((m_buffer_start + (m_buffer.size() / NUM_CHANNELS)) < end_sample)
+  {
+    if (FLAC__stream_decoder_get_state(m_decoder) == FLAC__STREAM_DECODER_END_OF_STREAM ||
+        !FLAC__stream_decoder_process_single(m_decoder))
+    {
+      Log_ErrorPrintf("Failed to decode FLAC frame at sample %" PRIu64,
+                      m_buffer_start + (m_buffer.size() / NUM_CHANNELS));
+      return false;
+    }
+  }
+
+  return m_buffer_start <= start_sample;
+}
+
+FLAC__StreamDecoderWriteStatus CDFLACReader::WriteCallback(const FLAC__StreamDecoder* decoder,
+                                                           const FLAC__Frame* frame,
+                                                           const FLAC__int32* const buffer[], void* client_data)
+{
+  CDFLACReader* reader = static_cast<CDFLACReader*>(client_data);
+
+  // Shouldn't happen outside of seeking, but if the stream jumps, don't splice mismatched samples together.
+  const u64 frame_start = frame->header.number.sample_number;
+  if (reader->m_buffer.empty() || frame_start != (reader->m_buffer_start + reader->m_buffer.size() / NUM_CHANNELS))
+  {
+    reader->m_buffer.clear();
+    reader->m_buffer_start = frame_start;
+  }
+
+  const u32 block_size = frame->header.blocksize;
+  const size_t old_size = reader->m_buffer.size();
+  reader->m_buffer.resize(old_size + (block_size * NUM_CHANNELS));
+
+  s16* out_ptr = reader->m_buffer.data() + old_size;
+  for (u32 i = 0; i < block_size; i++)
+  {
+    *(out_ptr++) = static_cast<s16>(buffer[0][i]);
+    *(out_ptr++) = static_cast<s16>(buffer[1][i]);
+  }
+
+  return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
+}
+
+void CDFLACReader::MetadataCallback(const FLAC__StreamDecoder* decoder, const FLAC__StreamMetadata* metadata,
+                                    void* client_data)
+{
+  if (metadata->type != FLAC__METADATA_TYPE_STREAMINFO)
+    return;
+
+  CDFLACReader* reader = static_cast<CDFLACReader*>(client_data);
+  const FLAC__StreamMetadata_StreamInfo& info = metadata->data.stream_info;
+  reader->m_total_samples = info.total_samples;
+  reader->m_format_supported =
+    (info.channels == NUM_CHANNELS && info.bits_per_sample == 16 && info.sample_rate == SAMPLE_RATE);
+}
+
+void CDFLACReader::ErrorCallback(const FLAC__StreamDecoder* decoder, FLAC__StreamDecoderErrorStatus status,
+                                 void* client_data)
+{
+  Log_ErrorPrintf("FLAC decode error: %s", FLAC__StreamDecoderErrorStatusString[status]);
+}
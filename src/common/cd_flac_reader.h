@@ -0,0 +1,56 @@
+#pragma once
+#include "types.h"
+#include <FLAC/stream_decoder.h>
+#include <vector>
+
+/// Decodes a FLAC-compressed CD audio track on demand, presenting it as raw 16-bit stereo PCM (i.e. BIN sectors).
+/// Sequential reads are decoded incrementally, only seeking the decoder when the read position jumps.
+class CDFLACReader
+{
+public:
+  CDFLACReader();
+  ~CDFLACReader();
+
+  bool Open(const char* filename);
+
+  /// Returns the size of the decoded audio in bytes.
+  u64 GetSize() const { return m_total_samples * BYTES_PER_SAMPLE; }
+
+  /// Reads decoded audio starting at the specified byte offset.
+  bool Read(u64 offset, void* buffer, u32 size);
+
+private:
+  enum : u32
+  {
+    NUM_CHANNELS = 2,
+    BYTES_PER_SAMPLE = NUM_CHANNELS * sizeof(s16),
+    SAMPLE_RATE = 44100,
+
+    // Decoded samples kept before the read position, so small backwards jumps don't seek.
+    HISTORY_SAMPLES = 588 * 16,
+
+    // Samples already read are only dropped once this many have built up past the history, to avoid moving the
+    // buffer contents on every read.
+    COMPACT_SAMPLES = 588 * 64,
+
+    // Forward jumps larger than this seek instead of decoding through the gap.
+    MAX_SKIP_SAMPLES = SAMPLE_RATE
+  };
+
+  bool DecodeSamples(u64 start_sample, u64 end_sample);
+
+  static FLAC__StreamDecoderWriteStatus WriteCallback(const FLAC__StreamDecoder* decoder, const FLAC__Frame* frame,
+                                                      const FLAC__int32* const buffer[], void* client_data);
+  static void MetadataCallback(const FLAC__StreamDecoder* decoder, const FLAC__StreamMetadata* metadata,
+                               void* client_data);
+  static void ErrorCallback(const FLAC__StreamDecoder* decoder, FLAC__StreamDecoderErrorStatus status,
+                            void* client_data);
+
+  FLAC__StreamDecoder* m_decoder = nullptr;
+  u64 m_total_samples = 0;
+  bool m_format_supported = false;
+
+  // Decoded samples [m_buffer_start, m_buffer_start + m_buffer.size() / NUM_CHANNELS), interleaved.
+  std::vector<s16> m_buffer;
+  u64 m_buffer_start = 0;
+};
@@ -35,6 +35,8 @@ std::unique_ptr<CDImage> CDImage::Open(const char* filename)
     return OpenBinImage(filename);
   else if (CASE_COMPARE(extension, ".chd") == 0)
     return OpenCHDImage(filename);
+  else if (CASE_COMPARE(extension, ".zip") == 0)
+    return OpenZipImage(filename);
 
 #undef CASE_COMPARE
 
@@ -54,6 +56,12 @@ CDImage::Position CDImage::GetTrackStartMSFPosition(u8 track) const
   return Position::FromLBA(m_tracks[track - 1].start_lba);
 }
 
+u32 CDImage::GetTrackNumberForDiscPosition(LBA pos) const
+{
+  const Index* index = GetIndexForDiscPosition(pos);
+  return index ? index->track_number : 0;
+}
+
 bool CDImage::Seek(LBA lba)
 {
   const Index* new_index;
@@ -114,8 +122,9 @@ u32 CDImage::Read(ReadMode read_mode, u32 sector_count, void* buffer)
   for (; sectors_read < sector_count; sectors_read++)
   {
     // get raw sector
-    u8 raw_sector[RAW_SECTOR_SIZE];
-    if (!ReadRawSector(raw_sector))
+    u8 raw_sector_buffer[RAW_SECTOR_SIZE];
+    const u8* raw_sector = ReadRawSectorPointer(raw_sector_buffer);
+    if (!raw_sector)
       break;
 
     switch (read_mode)
@@ -139,10 +148,6 @@ u32 CDImage::Read(ReadMode read_mode, u32 sector_count, void* buffer)
         UnreachableCode();
         break;
     }
-
-    m_position_on_disc++;
-    m_position_in_index++;
-    m_position_in_track++;
   }
 
   return sectors_read;
@@ -178,6 +183,34 @@ bool CDImage::ReadRawSector(void* buffer)
   return true;
 }
 
+const u8* CDImage::ReadRawSectorPointer(u8* buffer)
+{
+  if (m_position_in_index == m_current_index->length)
+  {
+    if (!Seek(m_position_on_disc))
+      return nullptr;
+  }
+
+  if (m_current_index->file_sector_size == RAW_SECTOR_SIZE)
+  {
+    const u8* sector = GetRawSectorPointerFromIndex(*m_current_index, m_position_in_index);
+    if (sector)
+    {
+      m_position_on_disc++;
+      m_position_in_index++;
+      m_position_in_track++;
+      return sector;
+    }
+  }
+
+  return ReadRawSector(buffer) ? buffer : nullptr;
+}
+
+const u8* CDImage::GetRawSectorPointerFromIndex(const Index& index, LBA lba_in_index)
+{
+  return nullptr;
+}
+
 bool CDImage::ReadSubChannelQ(SubChannelQ* subq)
 {
   // handle case where we're at the end of the track/index
@@ -189,7 +222,14 @@ bool CDImage::ReadSubChannelQ(SubChannelQ* subq)
   return true;
 }
 
-const CDImage::Index* CDImage::GetIndexForDiscPosition(LBA pos)
+void CDImage::SetDecompressedCacheSize(u32 blocks) {}
+
+bool CDImage::GetCacheStatistics(u32* hits, u32* misses) const
+{
+  return false;
+}
+
+const CDImage::Index* CDImage::GetIndexForDiscPosition(LBA pos) const
 {
   for (const Index& index : m_indices)
   {
@@ -1,6 +1,7 @@
 #pragma once
 #include "bitfield.h"
 #include "types.h"
+#include <functional>
 #include <memory>
 #include <string>
 #include <tuple>
@@ -152,14 +153,24 @@ public:
   };
   static_assert(sizeof(SubChannelQ) == SUBCHANNEL_BYTES_PER_FRAME, "SubChannelQ is correct size");
 
+  // Progress callback for long-running operations, receives the current and total number of steps.
+  using ProgressCallback = std::function<void(u32 progress_value, u32 progress_max)>;
+
   // Helper functions.
   static u32 GetBytesPerSector(TrackMode mode);
 
+  // Sets where seek indices for compressed images inside zip archives are cached.
+  static void SetZipIndexCacheDirectory(std::string directory);
+
   // Opening disc image.
   static std::unique_ptr<CDImage> Open(const char* filename);
   static std::unique_ptr<CDImage> OpenBinImage(const char* filename);
   static std::unique_ptr<CDImage> OpenCueSheetImage(const char* filename);
   static std::unique_ptr<CDImage> OpenCHDImage(const char* filename);
+  static std::unique_ptr<CDImage> OpenZipImage(const char* filename);
+
+  // Reads the whole of an image into memory. The image is re-opened on multiple threads to decompress in parallel.
+  static std::unique_ptr<CDImage> CreateMemoryImage(CDImage* image, const ProgressCallback& progress_callback = {});
 
   // Accessors.
   const std::string& GetFileName() const { return m_filename; }
@@ -174,6 +185,10 @@ public:
   LBA GetTrackStartPosition(u8 track) const;
   Position GetTrackStartMSFPosition(u8 track) const;
 
+  // Returns the track number containing the specified disc position, or 0 if it is past the end of the disc.
+  // Does not use the current position, so it is safe to call while another thread is reading.
+  u32 GetTrackNumberForDiscPosition(LBA pos) const;
+
   // Seek to data LBA.
   bool Seek(LBA lba);
 
@@ -192,9 +207,19 @@ public:
   // Read a single raw sector from the current LBA.
   bool ReadRawSector(void* buffer);
 
+  // Read a single raw sector from the current LBA, without copying if the backend can provide it directly.
+  // Returns either a pointer into the image, valid until the next read, or buffer. nullptr on failure.
+  const u8* ReadRawSectorPointer(u8* buffer);
+
   // Reads sub-channel Q for the current LBA.
   virtual bool ReadSubChannelQ(SubChannelQ* subq);
 
+  // Sets the number of decompressed blocks kept in memory by compressed formats. Ignored by other formats.
+  virtual void SetDecompressedCacheSize(u32 blocks);
+
+  // Returns the hit/miss counts of the decompressed block cache, or false if the format doesn't have one.
+  virtual bool GetCacheStatistics(u32* hits, u32* misses) const;
+
 protected:
   struct Track
   {
@@ -224,7 +249,11 @@ protected:
   // Reads a single sector from an index.
   virtual bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) = 0;
 
-  const Index* GetIndexForDiscPosition(LBA pos);
+  // Returns a pointer to a raw sector from an index, if the backend holds it in memory. Only called for indices
+  // with a file sector size of RAW_SECTOR_SIZE.
+  virtual const u8* GetRawSectorPointerFromIndex(const Index& index, LBA lba_in_index);
+
+  const Index* GetIndexForDiscPosition(LBA pos) const;
   const Index* GetIndexForTrackPosition(u32 track_number, LBA track_pos);
 
   /// Generates sub-channel Q given the specified position.
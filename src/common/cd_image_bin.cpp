@@ -2,6 +2,9 @@
 #include "cd_subchannel_replacement.h"
 #include "file_system.h"
 #include "log.h"
+#include "memory_mapped_file.h"
+#include <algorithm>
+#include <cstring>
 Log_SetChannel(CDImageBin);
 
 class CDImageBin : public CDImage
@@ -16,8 +19,11 @@ public:
 
 protected:
   bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
+  const u8* GetRawSectorPointerFromIndex(const Index& index, LBA lba_in_index) override;
 
 private:
+  // Images are mapped where possible, falling back to stdio if that fails (e.g. 32-bit address space).
+  MemoryMappedFile m_mapped_file;
   std::FILE* m_fp = nullptr;
   u64 m_file_position = 0;
 
@@ -46,21 +52,29 @@ CDImageBin::~CDImageBin()
 bool CDImageBin::Open(const char* filename)
 {
   m_filename = filename;
-  m_fp = FileSystem::OpenCFile(filename, "rb");
-  if (!m_fp)
+
+  u64 file_size;
+  if (m_mapped_file.Open(filename))
   {
-    Log_ErrorPrintf("Failed to open binfile '%s'", filename);
-    return false;
+    file_size = m_mapped_file.GetSize();
   }
+  else
+  {
+    m_fp = FileSystem::OpenCFile(filename, "rb");
+    if (!m_fp)
+    {
+      Log_ErrorPrintf("Failed to open binfile '%s'", filename);
+      return false;
+    }
 
-  const u32 track_sector_size = RAW_SECTOR_SIZE;
-
-  // determine the length from the file
-  std::fseek(m_fp, 0, SEEK_END);
-  const u32 file_size = static_cast<u32>(std::ftell(m_fp));
-  std::fseek(m_fp, 0, SEEK_SET);
+    // determine the length from the file
+    FileSystem::FSeek64(m_fp, 0, SEEK_END);
+    file_size = static_cast<u64>(std::max<s64>(FileSystem::FTell64(m_fp), 0));
+    FileSystem::FSeek64(m_fp, 0, SEEK_SET);
+  }
 
-  m_lba_count = file_size / track_sector_size;
+  const u32 track_sector_size = RAW_SECTOR_SIZE;
+  m_lba_count = static_cast<u32>(file_size / track_sector_size);
 
   SubChannelQ::Control control = {};
   TrackMode mode = TrackMode::Mode2Raw;
@@ -114,9 +128,18 @@ bool CDImageBin::ReadSubChannelQ(SubChannelQ* subq)
 bool CDImageBin::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index)
 {
   const u64 file_position = index.file_offset + (static_cast<u64>(lba_in_index) * index.file_sector_size);
+  if (m_mapped_file.IsOpen())
+  {
+    if ((file_position + index.file_sector_size) > m_mapped_file.GetSize())
+      return false;
+
+    std::memcpy(buffer, m_mapped_file.GetData() + file_position, index.file_sector_size);
+    return true;
+  }
+
   if (m_file_position != file_position)
   {
-    if (std::fseek(m_fp, static_cast<long>(file_position), SEEK_SET) != 0)
+    if (FileSystem::FSeek64(m_fp, static_cast<s64>(file_position), SEEK_SET) != 0)
       return false;
 
     m_file_position = file_position;
@@ -124,7 +147,7 @@ bool CDImageBin::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_i
 
   if (std::fread(buffer, index.file_sector_size, 1, m_fp) != 1)
   {
-    std::fseek(m_fp, static_cast<long>(m_file_position), SEEK_SET);
+    FileSystem::FSeek64(m_fp, static_cast<s64>(m_file_position), SEEK_SET);
     return false;
   }
 
@@ -132,6 +155,16 @@ bool CDImageBin::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_i
   return true;
 }
 
+const u8* CDImageBin::GetRawSectorPointerFromIndex(const Index& index, LBA lba_in_index)
+{
+  const u64 file_position = index.file_offset + (static_cast<u64>(lba_in_index) * index.file_sector_size);
+  if (!m_mapped_file.IsOpen() || (file_position + index.file_sector_size) > m_mapped_file.GetSize())
+    return nullptr;
+
+  m_mapped_file.ReadAhead(file_position);
+  return m_mapped_file.GetData() + file_position;
+}
+
 std::unique_ptr<CDImage> CDImage::OpenBinImage(const char* filename)
 {
   std::unique_ptr<CDImageBin> image = std::make_unique<CDImageBin>();
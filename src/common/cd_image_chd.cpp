@@ -10,10 +10,15 @@
 #include "libchdr/chd.h"
 #include "log.h"
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <cstdio>
 #include <cstring>
+#include <deque>
 #include <map>
+#include <mutex>
 #include <optional>
+#include <thread>
 Log_SetChannel(CDImageCHD);
 
 static std::optional<CDImage::TrackMode> ParseTrackModeString(const char* str)
@@ -48,6 +53,9 @@ public:
 
   bool ReadSubChannelQ(SubChannelQ* subq) override;
 
+  void SetDecompressedCacheSize(u32 blocks) override;
+  bool GetCacheStatistics(u32* hits, u32* misses) const override;
+
 protected:
   bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
 
@@ -55,16 +63,52 @@ private:
   enum : u32
   {
     CHD_SECTOR_DATA_SIZE = 2352 + 96,
+    DEFAULT_HUNK_CACHE_SIZE = 16,
+    PREFETCH_HUNK_COUNT = 2,
+    MIN_HUNK_CACHE_SIZE = PREFETCH_HUNK_COUNT + 1
   };
 
-  bool ReadHunk(u32 hunk_index);
+  struct CachedHunk
+  {
+    u32 hunk_index = static_cast<u32>(-1);
+    u32 last_used = 0;
+    bool pending = false;
+    std::vector<u8> data;
+  };
+
+  /// Returns the cache entry for the specified hunk, decompressing it if needed. Assumes m_cache_mutex is held.
+  CachedHunk* GetHunk(std::unique_lock<std::mutex>& lock, u32 hunk_index);
+
+  /// Picks the least-recently-used entry which is not being decompressed. Assumes m_cache_mutex is held.
+  CachedHunk* GetCacheVictim();
+
+  /// Replaces the prefetch queue with the hunks following hunk_index. Assumes m_cache_mutex is held.
+  void QueuePrefetch(u32 hunk_index);
+
+  void StartPrefetchThread();
+  void StopPrefetchThread();
+  void PrefetchThreadEntryPoint();
 
   chd_file* m_chd = nullptr;
   u32 m_hunk_size = 0;
   u32 m_sectors_per_hunk = 0;
+  u32 m_hunk_count = 0;
+
+  // Decompressed hunks, shared with the prefetch thread.
+  std::mutex m_cache_mutex;
+  std::condition_variable m_hunk_ready_cv;
+  std::vector<CachedHunk> m_hunk_cache;
+  u32 m_hunk_cache_counter = 0;
 
-  std::vector<u8> m_hunk_buffer;
-  u32 m_current_hunk_index = static_cast<u32>(-1);
+  // The prefetch thread uses its own handle, as chd_file is not thread safe.
+  chd_file* m_prefetch_chd = nullptr;
+  std::thread m_prefetch_thread;
+  std::condition_variable m_prefetch_cv;
+  std::deque<u32> m_prefetch_queue;
+  bool m_prefetch_shutdown = false;
+
+  std::atomic<u32> m_cache_hits{0};
+  std::atomic<u32> m_cache_misses{0};
 
   CDSubChannelReplacement m_sbi;
 };
@@ -73,6 +117,10 @@ CDImageCHD::CDImageCHD() = default;
 
 CDImageCHD::~CDImageCHD()
 {
+  StopPrefetchThread();
+
+  if (m_prefetch_chd)
+    chd_close(m_prefetch_chd);
   if (m_chd)
     chd_close(m_chd);
 }
@@ -82,7 +130,7 @@ bool CDImageCHD::Open(const char* filename)
   chd_error err = chd_open(filename, CHD_OPEN_READ, nullptr, &m_chd);
   if (err != CHDERR_NONE)
   {
-    Log_ErrorPrintf("Failed to open CHD '%s': %s", chd_error_string(err));
+    Log_ErrorPrintf("Failed to open CHD '%s': %s", filename, chd_error_string(err));
     return false;
   }
 
@@ -95,7 +143,7 @@ bool CDImageCHD::Open(const char* filename)
   }
 
   m_sectors_per_hunk = m_hunk_size / CHD_SECTOR_DATA_SIZE;
-  m_hunk_buffer.resize(m_hunk_size);
+  m_hunk_count = header->totalhunks;
   m_filename = filename;
 
   u32 disc_lba = 0;
@@ -229,6 +277,15 @@ bool CDImageCHD::Open(const char* filename)
 
   m_sbi.LoadSBI(FileSystem::ReplaceExtension(filename, "sbi").c_str());
 
+  // Not being able to open a second handle just means we won't decompress ahead.
+  err = chd_open(filename, CHD_OPEN_READ, nullptr, &m_prefetch_chd);
+  if (err != CHDERR_NONE)
+  {
+    Log_WarningPrintf("Failed to open prefetch handle for CHD '%s': %s", filename, chd_error_string(err));
+    m_prefetch_chd = nullptr;
+  }
+
+  SetDecompressedCacheSize(DEFAULT_HUNK_CACHE_SIZE);
   return Seek(1, Position{0, 0, 0});
 }
 
@@ -289,32 +346,185 @@ bool CDImageCHD::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_i
   const u32 hunk_offset = static_cast<u32>((disc_frame % m_sectors_per_hunk) * CHD_SECTOR_DATA_SIZE);
   DebugAssert((m_hunk_size - hunk_offset) >= CHD_SECTOR_DATA_SIZE);
 
-  if (m_current_hunk_index != hunk_index && !ReadHunk(hunk_index))
+  // The copy is done under the lock so the prefetch thread can't evict the hunk while we're reading it.
+  std::unique_lock<std::mutex> lock(m_cache_mutex);
+  const CachedHunk* hunk = GetHunk(lock, hunk_index);
+  if (!hunk)
     return false;
 
   // Audio data is in big-endian, so we have to swap it for little endian hosts...
   if (index.mode == TrackMode::Audio)
-    CopyAndSwap(buffer, &m_hunk_buffer[hunk_offset], RAW_SECTOR_SIZE);
+    CopyAndSwap(buffer, &hunk->data[hunk_offset], RAW_SECTOR_SIZE);
   else
-    std::memcpy(buffer, &m_hunk_buffer[hunk_offset], RAW_SECTOR_SIZE);
+    std::memcpy(buffer, &hunk->data[hunk_offset], RAW_SECTOR_SIZE);
 
   return true;
 }
 
-bool CDImageCHD::ReadHunk(u32 hunk_index)
+void CDImageCHD::SetDecompressedCacheSize(u32 blocks)
 {
-  const chd_error err = chd_read(m_chd, hunk_index, m_hunk_buffer.data());
-  if (err != CHDERR_NONE)
+  StopPrefetchThread();
+
+  m_hunk_cache.clear();
+  m_hunk_cache.resize(std::max<u32>(blocks, MIN_HUNK_CACHE_SIZE));
+  for (CachedHunk& hunk : m_hunk_cache)
+    hunk.data.resize(m_hunk_size);
+  m_hunk_cache_counter = 0;
+
+  if (m_prefetch_chd)
+    StartPrefetchThread();
+}
+
+bool CDImageCHD::GetCacheStatistics(u32* hits, u32* misses) const
+{
+  *hits = m_cache_hits.load();
+  *misses = m_cache_misses.load();
+  return true;
+}
+
+CDImageCHD::CachedHunk* CDImageCHD::GetHunk(std::unique_lock<std::mutex>& lock, u32 hunk_index)
+{
+  auto iter = std::find_if(m_hunk_cache.begin(), m_hunk_cache.end(),
+                           [hunk_index](const CachedHunk& hunk) { return hunk.hunk_index == hunk_index; });
+  CachedHunk* hunk = (iter != m_hunk_cache.end()) ? &(*iter) : nullptr;
+  if (hunk && hunk->pending)
   {
-    Log_ErrorPrintf("chd_read(%u) failed: %s", hunk_index, chd_error_string(err));
+    // being decompressed by the prefetch thread, wait for it rather than doing it again
+    m_hunk_ready_cv.wait(lock, [hunk]() { return !hunk->pending; });
+    if (hunk->hunk_index != hunk_index)
+      hunk = nullptr;
+  }
 
-    // data might have been partially written
-    m_current_hunk_index = static_cast<u32>(-1);
-    return false;
+  if (hunk)
+  {
+    m_cache_hits++;
   }
+  else
+  {
+    m_cache_misses++;
 
-  m_current_hunk_index = hunk_index;
-  return true;
+    hunk = GetCacheVictim();
+    hunk->hunk_index = hunk_index;
+    hunk->pending = true;
+
+    lock.unlock();
+    const chd_error err = chd_read(m_chd, hunk_index, hunk->data.data());
+    lock.lock();
+
+    hunk->pending = false;
+    m_hunk_ready_cv.notify_all();
+    if (err != CHDERR_NONE)
+    {
+      Log_ErrorPrintf("chd_read(%u) failed: %s", hunk_index, chd_error_string(err));
+
+      // data might have been partially written
+      hunk->hunk_index = static_cast<u32>(-1);
+      return nullptr;
+    }
+  }
+
+  hunk->last_used = ++m_hunk_cache_counter;
+  QueuePrefetch(hunk_index);
+  return hunk;
+}
+
+CDImageCHD::CachedHunk* CDImageCHD::GetCacheVictim()
+{
+  CachedHunk* victim = nullptr;
+  for (CachedHunk& hunk : m_hunk_cache)
+  {
+    if (!hunk.pending && (!victim || hunk.last_used < victim->last_used))
+      victim = &hunk;
+  }
+
+  // at most one hunk is pending per thread, and the cache is always larger than that
+  DebugAssert(victim);
+  return victim;
+}
+
+void CDImageCHD::QueuePrefetch(u32 hunk_index)
+{
+  if (!m_prefetch_thread.joinable())
+    return;
+
+  m_prefetch_queue.clear();
+  for (u32 i = 1; i <= PREFETCH_HUNK_COUNT; i++)
+  {
+    const u32 prefetch_hunk_index = hunk_index + i;
+    if (prefetch_hunk_index >= m_hunk_count)
+      break;
+
+    if (std::none_of(m_hunk_cache.begin(), m_hunk_cache.end(),
+                     [prefetch_hunk_index](const CachedHunk& hunk) { return hunk.hunk_index == prefetch_hunk_index; }))
+    {
+      m_prefetch_queue.push_back(prefetch_hunk_index);
+    }
+  }
+
+  if (!m_prefetch_queue.empty())
+    m_prefetch_cv.notify_one();
+}
+
+void CDImageCHD::StartPrefetchThread()
+{
+  m_prefetch_shutdown = false;
+  m_prefetch_thread = std::thread(&CDImageCHD::PrefetchThreadEntryPoint, this);
+}
+
+void CDImageCHD::StopPrefetchThread()
+{
+  if (!m_prefetch_thread.joinable())
+    return;
+
+  {
+    std::unique_lock<std::mutex> lock(m_cache_mutex);
+    m_prefetch_shutdown = true;
+    m_prefetch_queue.clear();
+    m_prefetch_cv.notify_one();
+  }
+
+  m_prefetch_thread.join();
+}
+
+void CDImageCHD::PrefetchThreadEntryPoint()
+{
+  std::unique_lock<std::mutex> lock(m_cache_mutex);
+  for (;;)
+  {
+    m_prefetch_cv.wait(lock, [this]() { return m_prefetch_shutdown || !m_prefetch_queue.empty(); });
+    if (m_prefetch_shutdown)
+      break;
+
+    const u32 hunk_index = m_prefetch_queue.front();
+    m_prefetch_queue.pop_front();
+    if (std::any_of(m_hunk_cache.begin(), m_hunk_cache.end(),
+                    [hunk_index](const CachedHunk& hunk) { return hunk.hunk_index == hunk_index; }))
+    {
+      continue;
+    }
+
+    CachedHunk* hunk = GetCacheVictim();
+    hunk->hunk_index = hunk_index;
+    hunk->pending = true;
+
+    lock.unlock();
+    const chd_error err = chd_read(m_prefetch_chd, hunk_index, hunk->data.data());
+    lock.lock();
+
+    hunk->pending = false;
+    if (err != CHDERR_NONE)
+    {
+      Log_WarningPrintf("Prefetch of hunk %u failed: %s", hunk_index, chd_error_string(err));
+      hunk->hunk_index = static_cast<u32>(-1);
+    }
+    else
+    {
+      // count as used, otherwise it'd be the next thing evicted
+      hunk->last_used = ++m_hunk_cache_counter;
+    }
+
+    m_hunk_ready_cv.notify_all();
+  }
 }
 
 std::unique_ptr<CDImage> CDImage::OpenCHDImage(const char* filename)
@@ -1,9 +1,14 @@
 #include "assert.h"
+#include "cd_flac_reader.h"
 #include "cd_image.h"
 #include "cd_subchannel_replacement.h"
+#include "cd_zip_reader.h"
 #include "file_system.h"
 #include "log.h"
+#include "memory_mapped_file.h"
+#include "string_util.h"
 #include <algorithm>
+#include <cstring>
 #include <libcue/libcue.h>
 #include <map>
 Log_SetChannel(CDImageCueSheet);
@@ -15,11 +20,13 @@ public:
   ~CDImageCueSheet() override;
 
   bool OpenAndParse(const char* filename);
+  bool OpenZip(const char* zip_filename);
 
   bool ReadSubChannelQ(SubChannelQ* subq) override;
 
 protected:
   bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
+  const u8* GetRawSectorPointerFromIndex(const Index& index, LBA lba_in_index) override;
 
 private:
   Cd* m_cd = nullptr;
@@ -27,19 +34,185 @@ private:
   struct TrackFile
   {
     std::string filename;
-    std::FILE* file;
-    u64 file_position;
+
+    // Track files are mapped where possible, otherwise read through stdio.
+    std::unique_ptr<MemoryMappedFile> mapped_file;
+    std::FILE* file = nullptr;
+    u64 file_position = 0;
+
+    // Offset of the sector data in the file, e.g. past a WAVE header, and the size of it.
+    u64 data_offset = 0;
+    u64 file_size = 0;
+
+    // FLAC tracks are decoded as they're read.
+    std::unique_ptr<CDFLACReader> flac_reader;
+
+    // Tracks inside a zip are read through the seek index, rather than extracted.
+    std::unique_ptr<CDZipReader> zip_reader;
   };
 
+  bool ParseTracks(const char* filename, const std::string& basepath);
+  bool OpenTrackFile(const char* path, TrackFile* tf);
+
+  // Set when the cue sheet and tracks come from a zip, in which case track paths are relative to the archive.
+  std::string m_zip_filename;
+
   std::vector<TrackFile> m_files;
   CDSubChannelReplacement m_sbi;
 };
 
 CDImageCueSheet::CDImageCueSheet() = default;
 
+// Returns the size of the ID3v2 tag at the start of the header, or zero if there isn't one. Tagging tools often put
+// one in front of FLAC streams.
+static u32 GetID3v2TagSize(const u8* header)
+{
+  if (std::memcmp(header, "ID3", 3) != 0)
+    return 0;
+
+  // The size is a 28-bit syncsafe integer, excluding the 10 byte header and the footer if present.
+  const u32 size = (ZeroExtend32(header[6] & 0x7Fu) << 21) | (ZeroExtend32(header[7] & 0x7Fu) << 14) |
+                   (ZeroExtend32(header[8] & 0x7Fu) << 7) | ZeroExtend32(header[9] & 0x7Fu);
+  return 10 + size + (((header[5] & 0x10u) != 0) ? 10 : 0);
+}
+
+// Finds the sample data in a RIFF WAVE file, which must be CD audio (16-bit stereo PCM at 44100hz).
+static bool FindWAVEData(std::FILE* fp, u64* data_offset, u64* data_size)
+{
+  FileSystem::FSeek64(fp, 0, SEEK_END);
+  const u64 file_size = static_cast<u64>(std::max<s64>(FileSystem::FTell64(fp), 0));
+
+  bool format_valid = false;
+  u64 chunk_offset = 12;
+  while ((chunk_offset + 8) <= file_size)
+  {
+    u8 chunk_header[8];
+    if (FileSystem::FSeek64(fp, static_cast<s64>(chunk_offset), SEEK_SET) != 0 ||
+        std::fread(chunk_header, sizeof(chunk_header), 1, fp) != 1)
+    {
+      break;
+    }
+
+    const u32 chunk_size = ZeroExtend32(chunk_header[4]) | (ZeroExtend32(chunk_header[5]) << 8) |
+                           (ZeroExtend32(chunk_header[6]) << 16) | (ZeroExtend32(chunk_header[7]) << 24);
+    if (std::memcmp(chunk_header, "fmt ", 4) == 0)
+    {
+      u8 fmt[16];
+      if (chunk_size < sizeof(fmt) || std::fread(fmt, sizeof(fmt), 1, fp) != 1)
+        break;
+
+      // PCM or WAVE_FORMAT_EXTENSIBLE, 2 channels, 44100hz, 16 bits per sample.
+      const u16 format_tag = ZeroExtend16(fmt[0]) | (ZeroExtend16(fmt[1]) << 8);
+      format_valid = (format_tag == 0x0001 || format_tag == 0xFFFE) && fmt[2] == 2 && fmt[3] == 0 &&
+                     fmt[4] == 0x44 && fmt[5] == 0xAC && fmt[6] == 0 && fmt[7] == 0 && fmt[14] == 16 && fmt[15] == 0;
+    }
+    else if (std::memcmp(chunk_header, "data", 4) == 0)
+    {
+      if (!format_valid)
+      {
+        Log_ErrorPrintf("WAVE file is not 16-bit stereo 44100hz PCM");
+        return false;
+      }
+
+      // Streamed files can leave the size unset, so trust the file size over it.
+      *data_offset = chunk_offset + 8;
+      *data_size = std::min<u64>(chunk_size, file_size - *data_offset);
+      return true;
+    }
+
+    // Chunks are word-aligned.
+    chunk_offset += 8 + chunk_size + (chunk_size & 1);
+  }
+
+  Log_ErrorPrintf("WAVE file has no data chunk");
+  return false;
+}
+
+bool CDImageCueSheet::OpenTrackFile(const char* path, TrackFile* tf)
+{
+  if (!m_zip_filename.empty())
+  {
+    tf->zip_reader = std::make_unique<CDZipReader>();
+    if (!tf->zip_reader->Open(m_zip_filename.c_str(), path))
+      return false;
+
+    tf->file_size = tf->zip_reader->GetSize();
+    return true;
+  }
+
+  std::FILE* fp = FileSystem::OpenCFile(path, "rb");
+  if (!fp)
+    return false;
+
+  // libcue doesn't give us the FILE type, so go by the header instead.
+  u8 header[12];
+  const bool has_header = (std::fread(header, sizeof(header), 1, fp) == 1);
+  bool is_flac = (has_header && std::memcmp(header, "fLaC", 4) == 0);
+  const u32 id3_tag_size = has_header ? GetID3v2TagSize(header) : 0;
+  if (id3_tag_size > 0)
+  {
+    // Audio with a tag is never raw sector data, so don't fall back to reading it as such.
+    u8 magic[4];
+    is_flac = (FileSystem::FSeek64(fp, static_cast<s64>(id3_tag_size), SEEK_SET) == 0 &&
+               std::fread(magic, sizeof(magic), 1, fp) == 1 && std::memcmp(magic, "fLaC", 4) == 0);
+    if (!is_flac)
+    {
+      Log_ErrorPrintf("'%s' has an ID3 tag, but is not a FLAC file", path);
+      std::fclose(fp);
+      return false;
+    }
+  }
+
+  if (is_flac)
+  {
+    // libFLAC skips the ID3 tag itself.
+    std::fclose(fp);
+    tf->flac_reader = std::make_unique<CDFLACReader>();
+    if (!tf->flac_reader->Open(path))
+      return false;
+
+    tf->file_size = tf->flac_reader->GetSize();
+    return true;
+  }
+
+  if (has_header && std::memcmp(header, "RIFF", 4) == 0 && std::memcmp(&header[8], "WAVE", 4) == 0)
+  {
+    if (!FindWAVEData(fp, &tf->data_offset, &tf->file_size))
+    {
+      std::fclose(fp);
+      return false;
+    }
+  }
+  else
+  {
+    FileSystem::FSeek64(fp, 0, SEEK_END);
+    tf->file_size = static_cast<u64>(std::max<s64>(FileSystem::FTell64(fp), 0));
+  }
+
+  tf->mapped_file = std::make_unique<MemoryMappedFile>();
+  if (tf->mapped_file->Open(path) && (tf->data_offset + tf->file_size) <= tf->mapped_file->GetSize())
+  {
+    std::fclose(fp);
+    return true;
+  }
+
+  tf->mapped_file.reset();
+  if (FileSystem::FSeek64(fp, static_cast<s64>(tf->data_offset), SEEK_SET) != 0)
+  {
+    std::fclose(fp);
+    return false;
+  }
+
+  tf->file = fp;
+  return true;
+}
+
 CDImageCueSheet::~CDImageCueSheet()
 {
-  std::for_each(m_files.begin(), m_files.end(), [](TrackFile& t) { std::fclose(t.file); });
+  std::for_each(m_files.begin(), m_files.end(), [](TrackFile& t) {
+    if (t.file)
+      std::fclose(t.file);
+  });
   cd_delete(m_cd);
 }
 
@@ -61,7 +234,67 @@ bool CDImageCueSheet::OpenAndParse(const char* filename)
   }
 
   // get the directory of the filename
-  std::string basepath = FileSystem::GetPathDirectory(filename) + "/";
+  return ParseTracks(filename, FileSystem::GetPathDirectory(filename) + "/");
+}
+
+bool CDImageCueSheet::OpenZip(const char* zip_filename)
+{
+  // Prefer a cue sheet, otherwise treat the first bin as a single data track.
+  std::string cue_name, bin_name;
+  for (const std::string& name : CDZipReader::GetFileNames(zip_filename))
+  {
+    const char* extension = std::strrchr(name.c_str(), '.');
+    if (!extension)
+      continue;
+
+    if (cue_name.empty() && StringUtil::Strcasecmp(extension, ".cue") == 0)
+      cue_name = name;
+    else if (bin_name.empty() &&
+             (StringUtil::Strcasecmp(extension, ".bin") == 0 || StringUtil::Strcasecmp(extension, ".img") == 0))
+      bin_name = name;
+  }
+
+  std::string basepath;
+  if (!cue_name.empty())
+  {
+    std::optional<std::string> cue_data = CDZipReader::ReadFileToString(zip_filename, cue_name.c_str());
+    if (!cue_data)
+    {
+      Log_ErrorPrintf("Failed to read '%s' from '%s'", cue_name.c_str(), zip_filename);
+      return false;
+    }
+
+    m_cd = cue_parse_string(cue_data->c_str());
+
+    const std::string::size_type pos = cue_name.rfind('/');
+    if (pos != std::string::npos)
+      basepath = cue_name.substr(0, pos + 1);
+  }
+  else if (!bin_name.empty())
+  {
+    m_cd = cue_parse_string(
+      StringUtil::StdStringFromFormat("FILE \"%s\" BINARY\n  TRACK 01 MODE2/2352\n    INDEX 01 00:00:00\n",
+                                      bin_name.c_str())
+        .c_str());
+  }
+  else
+  {
+    Log_ErrorPrintf("No disc image found in '%s'", zip_filename);
+    return false;
+  }
+
+  if (!m_cd)
+  {
+    Log_ErrorPrintf("Failed to parse cuesheet from '%s'", zip_filename);
+    return false;
+  }
+
+  m_zip_filename = zip_filename;
+  return ParseTracks(zip_filename, basepath);
+}
+
+bool CDImageCueSheet::ParseTracks(const char* filename, const std::string& basepath)
+{
   m_filename = filename;
 
   u32 disc_lba = 0;
@@ -88,15 +321,16 @@ bool CDImageCueSheet::OpenAndParse(const char* filename)
     if (track_file_index == m_files.size())
     {
       std::string track_full_filename = basepath + track_filename;
-      std::FILE* track_fp = FileSystem::OpenCFile(track_full_filename.c_str(), "rb");
-      if (!track_fp)
+      TrackFile track_file;
+      track_file.filename = track_filename;
+      if (!OpenTrackFile(track_full_filename.c_str(), &track_file))
       {
         Log_ErrorPrintf("Failed to open track filename '%s' (from '%s' and '%s')", track_full_filename.c_str(),
                         track_filename.c_str(), filename);
         return false;
       }
 
-      m_files.push_back(TrackFile{std::move(track_filename), track_fp, 0});
+      m_files.push_back(std::move(track_file));
     }
 
     // data type determines the sector size
@@ -113,11 +347,7 @@ bool CDImageCueSheet::OpenAndParse(const char* filename)
     // determine the length from the file
     if (track_length < 0)
     {
-      std::fseek(m_files[track_file_index].file, 0, SEEK_END);
-      long file_size = std::ftell(m_files[track_file_index].file);
-      std::fseek(m_files[track_file_index].file, 0, SEEK_SET);
-
-      file_size /= track_sector_size;
+      const long file_size = static_cast<long>(m_files[track_file_index].file_size / track_sector_size);
       Assert(track_start < file_size);
       track_length = file_size - track_start;
     }
@@ -189,7 +419,7 @@ bool CDImageCueSheet::OpenAndParse(const char* filename)
         last_index.length = 0;
       }
 
-      last_index.file_offset = index_offset * last_index.file_sector_size;
+      last_index.file_offset = static_cast<u64>(static_cast<s64>(index_offset)) * last_index.file_sector_size;
       last_index.index_number = static_cast<u32>(index_num);
       last_index_offset = index_offset;
     }
@@ -227,9 +457,23 @@ bool CDImageCueSheet::ReadSectorFromIndex(void* buffer, const Index& index, LBA
 
   TrackFile& tf = m_files[index.file_index];
   const u64 file_position = index.file_offset + (static_cast<u64>(lba_in_index) * index.file_sector_size);
+  if (tf.flac_reader)
+    return tf.flac_reader->Read(file_position, buffer, index.file_sector_size);
+  else if (tf.zip_reader)
+    return tf.zip_reader->Read(file_position, buffer, index.file_sector_size);
+
+  if (tf.mapped_file)
+  {
+    if ((file_position + index.file_sector_size) > tf.file_size)
+      return false;
+
+    std::memcpy(buffer, tf.mapped_file->GetData() + tf.data_offset + file_position, index.file_sector_size);
+    return true;
+  }
+
   if (tf.file_position != file_position)
   {
-    if (std::fseek(tf.file, static_cast<long>(file_position), SEEK_SET) != 0)
+    if (FileSystem::FSeek64(tf.file, static_cast<s64>(tf.data_offset + file_position), SEEK_SET) != 0)
       return false;
 
     tf.file_position = file_position;
@@ -237,7 +481,7 @@ bool CDImageCueSheet::ReadSectorFromIndex(void* buffer, const Index& index, LBA
 
   if (std::fread(buffer, index.file_sector_size, 1, tf.file) != 1)
   {
-    std::fseek(tf.file, static_cast<long>(tf.file_position), SEEK_SET);
+    FileSystem::FSeek64(tf.file, static_cast<s64>(tf.data_offset + tf.file_position), SEEK_SET);
     return false;
   }
 
@@ -245,6 +489,19 @@ bool CDImageCueSheet::ReadSectorFromIndex(void* buffer, const Index& index, LBA
   return true;
 }
 
+const u8* CDImageCueSheet::GetRawSectorPointerFromIndex(const Index& index, LBA lba_in_index)
+{
+  DebugAssert(index.file_index < m_files.size());
+
+  TrackFile& tf = m_files[index.file_index];
+  const u64 file_position = index.file_offset + (static_cast<u64>(lba_in_index) * index.file_sector_size);
+  if (!tf.mapped_file || (file_position + index.file_sector_size) > tf.file_size)
+    return nullptr;
+
+  tf.mapped_file->ReadAhead(tf.data_offset + file_position);
+  return tf.mapped_file->GetData() + tf.data_offset + file_position;
+}
+
 std::unique_ptr<CDImage> CDImage::OpenCueSheetImage(const char* filename)
 {
   std::unique_ptr<CDImageCueSheet> image = std::make_unique<CDImageCueSheet>();
@@ -253,3 +510,12 @@ std::unique_ptr<CDImage> CDImage::OpenCueSheetImage(const char* filename)
 
   return image;
 }
+
+std::unique_ptr<CDImage> CDImage::OpenZipImage(const char* filename)
+{
+  std::unique_ptr<CDImageCueSheet> image = std::make_unique<CDImageCueSheet>();
+  if (!image->OpenZip(filename))
+    return {};
+
+  return image;
+}
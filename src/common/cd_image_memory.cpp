@@ -0,0 +1,205 @@
+#include "assert.h"
+#include "cd_image.h"
+#include "log.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+Log_SetChannel(CDImageMemory);
+
+class CDImageMemory : public CDImage
+{
+public:
+  CDImageMemory();
+  ~CDImageMemory() override;
+
+  // Reads every sector covered by the indices from image. The caller copies the track layout.
+  bool CopyImage(CDImage* image, const std::vector<Index>& indices, const ProgressCallback& progress_callback);
+
+  bool ReadSubChannelQ(SubChannelQ* subq) override;
+
+protected:
+  bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
+  const u8* GetRawSectorPointerFromIndex(const Index& index, LBA lba_in_index) override;
+
+private:
+  enum : u32
+  {
+    // Number of sectors each thread reads before picking up more work. Large enough to cover several CHD hunks.
+    SECTORS_PER_CHUNK = 2048
+  };
+
+  void ReadSectors(CDImage* image, std::atomic<u32>& next_chunk, std::atomic_bool& failed,
+                   const ProgressCallback* progress_callback);
+
+  // Every sector on the disc is stored raw, indexed by its LBA.
+  std::unique_ptr<u8[]> m_memory;
+  std::unique_ptr<SubChannelQ[]> m_subchannel_q;
+  u32 m_memory_sectors = 0;
+};
+
+CDImageMemory::CDImageMemory() = default;
+
+CDImageMemory::~CDImageMemory() = default;
+
+bool CDImageMemory::CopyImage(CDImage* image, const std::vector<Index>& indices,
+                              const ProgressCallback& progress_callback)
+{
+  for (const Index& index : indices)
+    m_memory_sectors = std::max(m_memory_sectors, index.start_lba_on_disc + index.length);
+
+  const size_t memory_size = static_cast<size_t>(m_memory_sectors) * RAW_SECTOR_SIZE;
+  m_memory.reset(new (std::nothrow) u8[memory_size]);
+  m_subchannel_q.reset(new (std::nothrow) SubChannelQ[m_memory_sectors]);
+  if (!m_memory || !m_subchannel_q)
+  {
+    Log_ErrorPrintf("Failed to allocate %zu bytes for image '%s'", memory_size, image->GetFileName().c_str());
+    return false;
+  }
+
+  // Each extra thread has its own copy of the image, since they can't share a position (or decompressor).
+  const u32 thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+  std::vector<std::unique_ptr<CDImage>> thread_images;
+  for (u32 i = 1; i < thread_count; i++)
+  {
+    std::unique_ptr<CDImage> thread_image = CDImage::Open(image->GetFileName().c_str());
+    if (!thread_image)
+      break;
+
+    thread_images.push_back(std::move(thread_image));
+  }
+
+  Log_InfoPrintf("Loading %u sectors from '%s' with %u threads", m_memory_sectors, image->GetFileName().c_str(),
+                 static_cast<u32>(thread_images.size() + 1));
+
+  std::atomic<u32> next_chunk{0};
+  std::atomic_bool failed{false};
+  std::vector<std::thread> threads;
+  threads.reserve(thread_images.size());
+  for (std::unique_ptr<CDImage>& thread_image : thread_images)
+  {
+    threads.emplace_back([this, &thread_image, &next_chunk, &failed]() {
+      ReadSectors(thread_image.get(), next_chunk, failed, nullptr);
+    });
+  }
+
+  // The calling thread uses the original image, and is the only one which reports progress.
+  const LBA old_position = image->GetPositionOnDisc();
+  ReadSectors(image, next_chunk, failed, progress_callback ? &progress_callback : nullptr);
+  for (std::thread& thread : threads)
+    thread.join();
+  thread_images.clear();
+
+  image->Seek(old_position);
+  if (failed.load())
+    return false;
+
+  if (progress_callback)
+    progress_callback(m_memory_sectors, m_memory_sectors);
+
+  return true;
+}
+
+void CDImageMemory::ReadSectors(CDImage* image, std::atomic<u32>& next_chunk, std::atomic_bool& failed,
+                                const ProgressCallback* progress_callback)
+{
+  const u32 chunk_count = (m_memory_sectors + SECTORS_PER_CHUNK - 1) / SECTORS_PER_CHUNK;
+  u32 last_percent = 0;
+
+  for (;;)
+  {
+    const u32 chunk = next_chunk.fetch_add(1);
+    if (chunk >= chunk_count || failed.load())
+      return;
+
+    const LBA start_lba = chunk * SECTORS_PER_CHUNK;
+    const LBA end_lba = std::min(start_lba + SECTORS_PER_CHUNK, m_memory_sectors);
+    if (!image->Seek(start_lba))
+    {
+      Log_ErrorPrintf("Failed to seek to LBA %u in '%s'", start_lba, image->GetFileName().c_str());
+      failed.store(true);
+      return;
+    }
+
+    for (LBA lba = start_lba; lba < end_lba; lba++)
+    {
+      // Sub-channel Q has to be read first, since reading the sector moves the position.
+      if (!image->ReadSubChannelQ(&m_subchannel_q[lba]) ||
+          !image->ReadRawSector(&m_memory[static_cast<size_t>(lba) * RAW_SECTOR_SIZE]))
+      {
+        Log_ErrorPrintf("Failed to read LBA %u from '%s'", lba, image->GetFileName().c_str());
+        failed.store(true);
+        return;
+      }
+    }
+
+    if (progress_callback)
+    {
+      // Other threads may be ahead of us, so use the shared counter, not the chunk we just finished.
+      const u32 chunks_done = std::min(next_chunk.load(), chunk_count);
+      const u32 percent = chunks_done * 100 / chunk_count;
+      if (percent != last_percent)
+      {
+        (*progress_callback)(std::min(chunks_done * SECTORS_PER_CHUNK, m_memory_sectors), m_memory_sectors);
+        last_percent = percent;
+      }
+    }
+  }
+}
+
+bool CDImageMemory::ReadSubChannelQ(SubChannelQ* subq)
+{
+  if (m_position_on_disc >= m_memory_sectors)
+    return CDImage::ReadSubChannelQ(subq);
+
+  *subq = m_subchannel_q[m_position_on_disc];
+  return true;
+}
+
+bool CDImageMemory::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index)
+{
+  const LBA lba = index.start_lba_on_disc + lba_in_index;
+  DebugAssert(lba < m_memory_sectors);
+  std::memcpy(buffer, &m_memory[static_cast<size_t>(lba) * RAW_SECTOR_SIZE], RAW_SECTOR_SIZE);
+  return true;
+}
+
+const u8* CDImageMemory::GetRawSectorPointerFromIndex(const Index& index, LBA lba_in_index)
+{
+  const LBA lba = index.start_lba_on_disc + lba_in_index;
+  DebugAssert(lba < m_memory_sectors);
+  return &m_memory[static_cast<size_t>(lba) * RAW_SECTOR_SIZE];
+}
+
+std::unique_ptr<CDImage> CDImage::CreateMemoryImage(CDImage* image, const ProgressCallback& progress_callback)
+{
+  std::unique_ptr<CDImageMemory> memory_image = std::make_unique<CDImageMemory>();
+  if (!memory_image->CopyImage(image, image->m_indices, progress_callback))
+    return {};
+
+  CDImage* base = memory_image.get();
+  base->m_filename = image->m_filename;
+  base->m_lba_count = image->m_lba_count;
+  // Copy-constructed, since the BitFields in the control field can't be assigned.
+  base->m_tracks = std::vector<Track>(image->m_tracks);
+  base->m_indices = std::vector<Index>(image->m_indices);
+
+  // Point the indices at the memory copy. Implicit pregaps aren't backed by the file, so they stay that way.
+  for (Index& index : base->m_indices)
+  {
+    if (index.file_sector_size == 0)
+      continue;
+
+    index.file_index = 0;
+    index.file_sector_size = RAW_SECTOR_SIZE;
+    index.file_offset = static_cast<u64>(index.start_lba_on_disc) * RAW_SECTOR_SIZE;
+  }
+
+  // The source may be positioned past the end of the disc, in which case we start at the beginning.
+  if (!base->Seek(image->GetPositionOnDisc()) && !base->Seek(static_cast<LBA>(0)))
+    return {};
+
+  return memory_image;
+}
@@ -1,19 +1,72 @@
 #include "cd_xa.h"
 #include "cd_image.h"
+#include "cpu_detect.h"
 #include <algorithm>
 #include <array>
+#include <cstring>
+#if defined(CPU_X64)
+#include <emmintrin.h>
+#elif defined(CPU_AARCH64)
+#include <arm_neon.h>
+#endif
 
 namespace CDXA {
 static constexpr std::array<s32, 4> s_xa_adpcm_filter_table_pos = {{0, 60, 115, 98}};
 static constexpr std::array<s32, 4> s_xa_adpcm_filter_table_neg = {{0, 0, -52, -55}};
 
+static constexpr u32 WORDS_PER_BLOCK = 28;
+
+// Extracts the specified nibble from each word of a chunk, as a sample shifted down by the block's shift. 8-bit
+// blocks only use the low nibble of each byte, matching the 16-bit truncation in the scalar decoder.
+static void ExtractXA_ADPCMNibbles(const u8* words_ptr, u32 nibble, u8 shift, s32* out_samples)
+{
+  static_assert((WORDS_PER_BLOCK % 4) == 0, "words can be extracted four at a time");
+
+#if defined(CPU_X64)
+  // Move the nibble to bits 12..15 and mask off the others, then sign-extend from 16 bits before applying the shift.
+  const u32 nibble_pos = nibble * 4;
+  const __m128i mask = _mm_set1_epi32(0xF000);
+  const __m128i left_count = _mm_cvtsi32_si128((nibble_pos <= 12) ? static_cast<int>(12 - nibble_pos) : 0);
+  const __m128i right_count = _mm_cvtsi32_si128((nibble_pos > 12) ? static_cast<int>(nibble_pos - 12) : 0);
+  const __m128i shift_count = _mm_cvtsi32_si128(shift);
+  for (u32 word = 0; word < WORDS_PER_BLOCK; word += 4)
+  {
+    __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&words_ptr[word * sizeof(u32)]));
+    words = _mm_and_si128(_mm_srl_epi32(_mm_sll_epi32(words, left_count), right_count), mask);
+    words = _mm_srai_epi32(_mm_slli_epi32(words, 16), 16);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&out_samples[word]), _mm_sra_epi32(words, shift_count));
+  }
+#elif defined(CPU_AARCH64)
+  // Negative counts shift right.
+  const uint32x4_t mask = vdupq_n_u32(0xF000);
+  const int32x4_t nibble_count = vdupq_n_s32(12 - static_cast<s32>(nibble * 4));
+  const int32x4_t shift_count = vdupq_n_s32(-static_cast<s32>(shift));
+  for (u32 word = 0; word < WORDS_PER_BLOCK; word += 4)
+  {
+    uint32x4_t words = vld1q_u32(reinterpret_cast<const u32*>(&words_ptr[word * sizeof(u32)]));
+    words = vandq_u32(vshlq_u32(words, nibble_count), mask);
+    const int32x4_t samples = vshrq_n_s32(vshlq_n_s32(vreinterpretq_s32_u32(words), 16), 16);
+    vst1q_s32(&out_samples[word], vshlq_s32(samples, shift_count));
+  }
+#else
+  for (u32 word = 0; word < WORDS_PER_BLOCK; word++)
+  {
+    // NOTE: assumes LE
+    u32 word_data;
+    std::memcpy(&word_data, &words_ptr[word * sizeof(u32)], sizeof(word_data));
+
+    const u32 value = (word_data >> (nibble * 4)) & 0x0F;
+    out_samples[word] = static_cast<s16>(Truncate16(value << 12)) >> shift;
+  }
+#endif
+}
+
 template<bool IS_STEREO, bool IS_8BIT>
 static void DecodeXA_ADPCMChunk(const u8* chunk_ptr, s16* samples, s32* last_samples)
 {
   // The data layout is annoying here. Each word of data is interleaved with the other blocks, requiring multiple
   // passes to decode the whole chunk.
   constexpr u32 NUM_BLOCKS = IS_8BIT ? 4 : 8;
-  constexpr u32 WORDS_PER_BLOCK = 28;
 
   const u8* headers_ptr = chunk_ptr + 4;
   const u8* words_ptr = chunk_ptr + 16;
@@ -26,31 +79,32 @@ static void DecodeXA_ADPCMChunk(const u8* chunk_ptr, s16* samples, s32* last_sam
     const s32 filter_pos = s_xa_adpcm_filter_table_pos[filter];
     const s32 filter_neg = s_xa_adpcm_filter_table_neg[filter];
 
+    // The filter depends on the previous output, so only the nibble extraction can be done in parallel.
+    std::array<s32, WORDS_PER_BLOCK> block_samples;
+    ExtractXA_ADPCMNibbles(words_ptr, IS_8BIT ? (block * 2) : block, shift, block_samples.data());
+
     s16* out_samples_ptr =
       IS_STEREO ? &samples[(block / 2) * (WORDS_PER_BLOCK * 2) + (block % 2)] : &samples[block * WORDS_PER_BLOCK];
     constexpr u32 out_samples_increment = IS_STEREO ? 2 : 1;
 
-    for (u32 word = 0; word < 28; word++)
-    {
-      // NOTE: assumes LE
-      u32 word_data;
-      std::memcpy(&word_data, &words_ptr[word * sizeof(u32)], sizeof(word_data));
-
-      // extract nibble from block
-      const u32 nibble = IS_8BIT ? ((word_data >> (block * 8)) & 0xFF) : ((word_data >> (block * 4)) & 0x0F);
-      const s16 sample = static_cast<s16>(Truncate16(nibble << 12)) >> shift;
-
-      // mix in previous values
-      s32* prev = IS_STEREO ? &last_samples[(block & 1) * 2] : last_samples;
-      const s32 interp_sample = s32(sample) + ((prev[0] * filter_pos) + (prev[1] * filter_neg) + 32) / 64;
+    // mix in previous values
+    s32* prev = IS_STEREO ? &last_samples[(block & 1) * 2] : last_samples;
+    s32 prev0 = prev[0];
+    s32 prev1 = prev[1];
 
-      // update previous values
-      prev[1] = prev[0];
-      prev[0] = interp_sample;
+    for (u32 word = 0; word < WORDS_PER_BLOCK; word++)
+    {
+      const s32 interp_sample = block_samples[word] + ((prev0 * filter_pos) + (prev1 * filter_neg) + 32) / 64;
+      prev1 = prev0;
+      prev0 = interp_sample;
 
       *out_samples_ptr = static_cast<s16>(std::clamp<s32>(interp_sample, -0x8000, 0x7FFF));
       out_samples_ptr += out_samples_increment;
     }
+
+    // update previous values
+    prev[0] = prev0;
+    prev[1] = prev1;
   }
 }
 
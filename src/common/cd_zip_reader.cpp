@@ -0,0 +1,418 @@
+#include "cd_zip_reader.h"
+#include "byte_stream.h"
+#include "cd_image.h"
+#include "file_system.h"
+#include "log.h"
+#include "string_util.h"
+#include <algorithm>
+#include <cstring>
+#include <unzip.h>
+Log_SetChannel(CDZipReader);
+
+static std::string s_index_cache_directory;
+
+CDZipReader::CDZipReader() = default;
+
+CDZipReader::~CDZipReader()
+{
+  if (m_access_points.size() > m_saved_access_point_count)
+    SaveIndexCache();
+
+  if (m_deflated)
+    inflateEnd(&m_stream);
+
+  if (m_fp)
+    std::fclose(m_fp);
+}
+
+void CDZipReader::SetIndexCacheDirectory(std::string directory)
+{
+  s_index_cache_directory = std::move(directory);
+}
+
+std::vector<std::string> CDZipReader::GetFileNames(const char* zip_filename)
+{
+  std::vector<std::string> names;
+  unzFile zf = unzOpen64(zip_filename);
+  if (!zf)
+    return names;
+
+  for (int res = unzGoToFirstFile(zf); res == UNZ_OK; res = unzGoToNextFile(zf))
+  {
+    char name[1024];
+    if (unzGetCurrentFileInfo64(zf, nullptr, name, sizeof(name), nullptr, 0, nullptr, 0) == UNZ_OK)
+      names.emplace_back(name);
+  }
+
+  unzClose(zf);
+  return names;
+}
+
+std::optional<std::string> CDZipReader::ReadFileToString(const char* zip_filename, const char* name)
+{
+  // Only meant for cue sheets and the like, so don't go allocating gigabytes.
+  static constexpr u64 MAX_SIZE = 1024 * 1024;
+
+  unzFile zf = unzOpen64(zip_filename);
+  if (!zf)
+    return std::nullopt;
+
+  std::optional<std::string> ret;
+  unz_file_info64 info;
+  if (unzLocateFile(zf, name, 2) == UNZ_OK &&
+      unzGetCurrentFileInfo64(zf, &info, nullptr, 0, nullptr, 0, nullptr, 0) == UNZ_OK &&
+      info.uncompressed_size <= MAX_SIZE && unzOpenCurrentFile(zf) == UNZ_OK)
+  {
+    std::string data(static_cast<size_t>(info.uncompressed_size), '\0');
+    if (data.empty() ||
+        unzReadCurrentFile(zf, data.data(), static_cast<unsigned>(data.size())) == static_cast<int>(data.size()))
+    {
+      ret = std::move(data);
+    }
+
+    unzCloseCurrentFile(zf);
+  }
+
+  unzClose(zf);
+  return ret;
+}
+
+bool CDZipReader::Open(const char* zip_filename, const char* name)
+{
+  unzFile zf = unzOpen64(zip_filename);
+  if (!zf)
+  {
+    Log_ErrorPrintf("Failed to open zip file '%s'", zip_filename);
+    return false;
+  }
+
+  unz_file_info64 info;
+  if (unzLocateFile(zf, name, 2) != UNZ_OK ||
+      unzGetCurrentFileInfo64(zf, &info, nullptr, 0, nullptr, 0, nullptr, 0) != UNZ_OK)
+  {
+    Log_ErrorPrintf("Failed to find '%s' in '%s'", name, zip_filename);
+    unzClose(zf);
+    return false;
+  }
+
+  if ((info.compression_method != 0 && info.compression_method != Z_DEFLATED) || (info.flag & 1) != 0)
+  {
+    Log_ErrorPrintf("'%s' in '%s' is encrypted or uses an unsupported compression method (%u)", name, zip_filename,
+                    static_cast<u32>(info.compression_method));
+    unzClose(zf);
+    return false;
+  }
+
+  // Opening the file raw gives us the offset of the data, after the local header.
+  int method, level;
+  if (unzOpenCurrentFile2(zf, &method, &level, 1) != UNZ_OK)
+  {
+    Log_ErrorPrintf("Failed to open '%s' in '%s'", name, zip_filename);
+    unzClose(zf);
+    return false;
+  }
+
+  m_data_offset = unzGetCurrentFileZStreamPos64(zf);
+  unzCloseCurrentFile(zf);
+  unzClose(zf);
+
+  m_zip_filename = zip_filename;
+  m_name = name;
+  m_compressed_size = info.compressed_size;
+  m_size = info.uncompressed_size;
+  m_crc32 = static_cast<u32>(info.crc);
+
+  m_fp = FileSystem::OpenCFile(zip_filename, "rb");
+  if (!m_fp)
+    return false;
+
+  if (info.compression_method == 0)
+    return true;
+
+  if (inflateInit2(&m_stream, -MAX_WBITS) != Z_OK)
+    return false;
+
+  m_deflated = true;
+  m_window = std::make_unique<u8[]>(WINDOW_SIZE);
+  m_input_buffer = std::make_unique<u8[]>(INPUT_BUFFER_SIZE);
+
+  LoadIndexCache();
+  if (m_access_points.empty())
+    m_access_points.push_back(AccessPoint{0, 0, 0, nullptr});
+
+  return true;
+}
+
+bool CDZipReader::Read(u64 offset, void* buffer, u32 size)
+{
+  if ((offset + size) > m_size)
+    return false;
+
+  return m_deflated ? ReadDeflated(offset, buffer, size) : ReadStored(offset, buffer, size);
+}
+
+bool CDZipReader::ReadStored(u64 offset, void* buffer, u32 size)
+{
+  return (FileSystem::FSeek64(m_fp, static_cast<s64>(m_data_offset + offset), SEEK_SET) == 0 &&
+          std::fread(buffer, size, 1, m_fp) == 1);
+}
+
+bool CDZipReader::ReadDeflated(u64 offset, void* buffer, u32 size)
+{
+  // Inflate works a window at a time, so sequential reads are usually already decompressed.
+  if (m_stream_valid && offset < m_stream_uncompressed_offset &&
+      (m_stream_uncompressed_offset - offset) <= m_window_valid_bytes)
+  {
+    const u32 behind = static_cast<u32>(m_stream_uncompressed_offset - offset);
+    const u32 copy_size = std::min(size, behind);
+    const u32 start = (m_window_position + WINDOW_SIZE - behind) % WINDOW_SIZE;
+    const u32 first_part = std::min(copy_size, WINDOW_SIZE - start);
+    std::memcpy(buffer, m_window.get() + start, first_part);
+    std::memcpy(static_cast<u8*>(buffer) + first_part, m_window.get(), copy_size - first_part);
+    if (copy_size == size)
+      return true;
+
+    offset += copy_size;
+    buffer = static_cast<u8*>(buffer) + copy_size;
+    size -= copy_size;
+  }
+
+  // Use the closest access point, unless we're already between it and the offset.
+  const auto next_point = std::upper_bound(
+    m_access_points.begin(), m_access_points.end(), offset,
+    [](u64 value, const AccessPoint& point) { return value < point.uncompressed_offset; });
+  const AccessPoint& point = *(next_point - 1);
+  if (!m_stream_valid || offset < m_stream_uncompressed_offset ||
+      point.uncompressed_offset > m_stream_uncompressed_offset)
+  {
+    if (!ResetStream(point))
+      return false;
+  }
+
+  u8* const out_ptr = static_cast<u8*>(buffer);
+  const u64 end_offset = offset + size;
+  while (m_stream_uncompressed_offset < end_offset)
+  {
+    if (m_stream.avail_in == 0 && m_stream_compressed_offset < m_compressed_size)
+    {
+      const u32 read_size =
+        static_cast<u32>(std::min<u64>(INPUT_BUFFER_SIZE, m_compressed_size - m_stream_compressed_offset));
+      if (FileSystem::FSeek64(m_fp, static_cast<s64>(m_data_offset + m_stream_compressed_offset), SEEK_SET) != 0 ||
+          std::fread(m_input_buffer.get(), read_size, 1, m_fp) != 1)
+      {
+        Log_ErrorPrintf("Failed to read compressed data for '%s'", m_name.c_str());
+        m_stream_valid = false;
+        return false;
+      }
+
+      m_stream.next_in = m_input_buffer.get();
+      m_stream.avail_in = read_size;
+      m_stream_compressed_offset += read_size;
+    }
+
+    if (m_window_position == WINDOW_SIZE)
+      m_window_position = 0;
+
+    // Z_BLOCK stops at the end of each deflate block, which are the only places we can put access points.
+    m_stream.next_out = m_window.get() + m_window_position;
+    m_stream.avail_out = WINDOW_SIZE - m_window_position;
+    const int ret = inflate(&m_stream, Z_BLOCK);
+    if (ret != Z_OK && ret != Z_STREAM_END)
+    {
+      Log_ErrorPrintf("inflate() failed for '%s': %d", m_name.c_str(), ret);
+      m_stream_valid = false;
+      return false;
+    }
+
+    const u32 produced = (WINDOW_SIZE - m_window_position) - m_stream.avail_out;
+    const u64 produced_end = m_stream_uncompressed_offset + produced;
+    if (produced_end > offset)
+    {
+      const u64 copy_start = std::max(m_stream_uncompressed_offset, offset);
+      const u64 copy_end = std::min(produced_end, end_offset);
+      std::memcpy(out_ptr + (copy_start - offset),
+                  m_window.get() + m_window_position + (copy_start - m_stream_uncompressed_offset),
+                  static_cast<size_t>(copy_end - copy_start));
+    }
+
+    m_window_position += produced;
+    m_window_valid_bytes = std::min<u32>(m_window_valid_bytes + produced, WINDOW_SIZE);
+    m_stream_uncompressed_offset = produced_end;
+    if (ret == Z_STREAM_END)
+    {
+      m_stream_valid = false;
+      return (m_stream_uncompressed_offset >= end_offset);
+    }
+
+    // Bit 7 is set at the end of a block, bit 6 if it's the last block.
+    if ((m_stream.data_type & 128) != 0 && (m_stream.data_type & 64) == 0 &&
+        m_stream_uncompressed_offset >= (m_access_points.back().uncompressed_offset + ACCESS_POINT_SPAN))
+    {
+      AddAccessPoint();
+    }
+  }
+
+  return true;
+}
+
+bool CDZipReader::ResetStream(const AccessPoint& point)
+{
+  inflateReset(&m_stream);
+  m_stream.next_in = nullptr;
+  m_stream.avail_in = 0;
+  m_stream_valid = false;
+
+  // If the point is in the middle of a byte, the remaining bits have to be fed in first.
+  m_stream_compressed_offset = point.compressed_offset - (point.bits ? 1 : 0);
+  if (point.bits != 0)
+  {
+    u8 value;
+    if (FileSystem::FSeek64(m_fp, static_cast<s64>(m_data_offset + m_stream_compressed_offset), SEEK_SET) != 0 ||
+        std::fread(&value, sizeof(value), 1, m_fp) != 1)
+    {
+      return false;
+    }
+
+    m_stream_compressed_offset++;
+    inflatePrime(&m_stream, point.bits, value >> (8 - point.bits));
+  }
+
+  if (point.window)
+  {
+    inflateSetDictionary(&m_stream, point.window.get(), WINDOW_SIZE);
+    std::memcpy(m_window.get(), point.window.get(), WINDOW_SIZE);
+  }
+
+  m_window_position = 0;
+  m_window_valid_bytes = point.window ? WINDOW_SIZE : 0;
+  m_stream_uncompressed_offset = point.uncompressed_offset;
+  m_stream_valid = true;
+  return true;
+}
+
+void CDZipReader::AddAccessPoint()
+{
+  AccessPoint point;
+  point.uncompressed_offset = m_stream_uncompressed_offset;
+  point.compressed_offset = m_stream_compressed_offset - m_stream.avail_in;
+  point.bits = static_cast<u32>(m_stream.data_type & 7);
+
+  // Unwrap the circular window, oldest data first.
+  point.window = std::make_unique<u8[]>(WINDOW_SIZE);
+  const u32 tail_size = WINDOW_SIZE - m_window_position;
+  std::memcpy(point.window.get(), m_window.get() + m_window_position, tail_size);
+  std::memcpy(point.window.get() + tail_size, m_window.get(), m_window_position);
+
+  m_access_points.push_back(std::move(point));
+}
+
+std::string CDZipReader::GetIndexCacheFileName() const
+{
+  if (s_index_cache_directory.empty())
+    return {};
+
+  const std::string key = m_zip_filename + '/' + m_name;
+  const u32 key_hash =
+    static_cast<u32>(crc32(0, reinterpret_cast<const Bytef*>(key.data()), static_cast<uInt>(key.size())));
+  return StringUtil::StdStringFromFormat("%s%c%08X.zipindex", s_index_cache_directory.c_str(),
+                                         FS_OSPATH_SEPERATOR_CHARACTER, key_hash);
+}
+
+void CDZipReader::LoadIndexCache()
+{
+  const std::string filename = GetIndexCacheFileName();
+  if (filename.empty())
+    return;
+
+  std::unique_ptr<ByteStream> stream =
+    FileSystem::OpenFile(filename.c_str(), BYTESTREAM_OPEN_READ | BYTESTREAM_OPEN_STREAMED);
+  if (!stream)
+    return;
+
+  // The index is only valid for the same file, which we check by its CRC and sizes.
+  u32 signature, version, crc, point_count;
+  u64 compressed_size, size;
+  if (!stream->Read2(&signature, sizeof(signature)) || !stream->Read2(&version, sizeof(version)) ||
+      !stream->Read2(&crc, sizeof(crc)) || !stream->Read2(&compressed_size, sizeof(compressed_size)) ||
+      !stream->Read2(&size, sizeof(size)) || !stream->Read2(&point_count, sizeof(point_count)) ||
+      signature != INDEX_CACHE_SIGNATURE || version != INDEX_CACHE_VERSION || crc != m_crc32 ||
+      compressed_size != m_compressed_size || size != m_size || point_count == 0)
+  {
+    Log_WarningPrintf("Ignoring out of date index cache '%s'", filename.c_str());
+    return;
+  }
+
+  std::vector<AccessPoint> points;
+  points.reserve(point_count);
+  for (u32 i = 0; i < point_count; i++)
+  {
+    AccessPoint point;
+    u8 has_window;
+    if (!stream->Read2(&point.uncompressed_offset, sizeof(point.uncompressed_offset)) ||
+        !stream->Read2(&point.compressed_offset, sizeof(point.compressed_offset)) ||
+        !stream->Read2(&point.bits, sizeof(point.bits)) || !stream->Read2(&has_window, sizeof(has_window)) ||
+        point.bits > 7 || point.uncompressed_offset > m_size || point.compressed_offset > m_compressed_size ||
+        (i > 0 && point.uncompressed_offset <= points.back().uncompressed_offset))
+    {
+      Log_WarningPrintf("Index cache '%s' is corrupted", filename.c_str());
+      return;
+    }
+
+    if (has_window)
+    {
+      point.window = std::make_unique<u8[]>(WINDOW_SIZE);
+      if (!stream->Read2(point.window.get(), WINDOW_SIZE))
+        return;
+    }
+
+    points.push_back(std::move(point));
+  }
+
+  Log_DevPrintf("Loaded %u access points for '%s' from '%s'", point_count, m_name.c_str(), filename.c_str());
+  m_access_points = std::move(points);
+  m_saved_access_point_count = m_access_points.size();
+}
+
+void CDZipReader::SaveIndexCache()
+{
+  const std::string filename = GetIndexCacheFileName();
+  if (filename.empty())
+    return;
+
+  // Atomic, since several readers (e.g. when preloading) can save the same index.
+  std::unique_ptr<ByteStream> stream =
+    FileSystem::OpenFile(filename.c_str(), BYTESTREAM_OPEN_CREATE | BYTESTREAM_OPEN_WRITE | BYTESTREAM_OPEN_TRUNCATE |
+                                             BYTESTREAM_OPEN_ATOMIC_UPDATE | BYTESTREAM_OPEN_STREAMED);
+  if (!stream)
+    return;
+
+  const u32 signature = INDEX_CACHE_SIGNATURE;
+  const u32 version = INDEX_CACHE_VERSION;
+  const u32 point_count = static_cast<u32>(m_access_points.size());
+  bool result = stream->Write2(&signature, sizeof(signature)) && stream->Write2(&version, sizeof(version)) &&
+                stream->Write2(&m_crc32, sizeof(m_crc32)) &&
+                stream->Write2(&m_compressed_size, sizeof(m_compressed_size)) &&
+                stream->Write2(&m_size, sizeof(m_size)) && stream->Write2(&point_count, sizeof(point_count));
+  for (const AccessPoint& point : m_access_points)
+  {
+    const u8 has_window = point.window ? 1 : 0;
+    result = result && stream->Write2(&point.uncompressed_offset, sizeof(point.uncompressed_offset)) &&
+             stream->Write2(&point.compressed_offset, sizeof(point.compressed_offset)) &&
+             stream->Write2(&point.bits, sizeof(point.bits)) && stream->Write2(&has_window, sizeof(has_window)) &&
+             (!has_window || stream->Write2(point.window.get(), WINDOW_SIZE));
+  }
+
+  if (!result || !stream->Commit())
+  {
+    Log_WarningPrintf("Failed to save index cache '%s'", filename.c_str());
+    stream->Discard();
+    return;
+  }
+
+  Log_DevPrintf("Saved %u access points for '%s' to '%s'", point_count, m_name.c_str(), filename.c_str());
+}
+
+void CDImage::SetZipIndexCacheDirectory(std::string directory)
+{
+  CDZipReader::SetIndexCacheDirectory(std::move(directory));
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include "types.h"
+#include <cstdio>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+/// Provides random access to a file inside a zip archive, without extracting it. Stored files are read directly.
+/// Deflated files are decompressed on demand, with access points recorded every few megabytes so that seeking only
+/// has to decompress from the nearest one. The access points are saved to the index cache directory (if set), so
+/// they only have to be built once for each archive.
+class CDZipReader
+{
+public:
+  CDZipReader();
+  ~CDZipReader();
+
+  /// Sets the directory where seek indices are saved. Empty disables saving them.
+  static void SetIndexCacheDirectory(std::string directory);
+
+  /// Returns the names of all files in the archive.
+  static std::vector<std::string> GetFileNames(const char* zip_filename);
+
+  /// Decompresses a (small) file from the archive in its entirety.
+  static std::optional<std::string> ReadFileToString(const char* zip_filename, const char* name);
+
+  bool Open(const char* zip_filename, const char* name);
+
+  /// Returns the uncompressed size of the file.
+  u64 GetSize() const { return m_size; }
+
+  bool Read(u64 offset, void* buffer, u32 size);
+
+private:
+  enum : u32
+  {
+    INDEX_CACHE_SIGNATURE = 0x585A4443, // CDZX
+    INDEX_CACHE_VERSION = 1,
+
+    WINDOW_SIZE = 32768,
+    INPUT_BUFFER_SIZE = 65536,
+
+    // Spacing of access points, in uncompressed bytes. Each one costs a window of memory.
+    ACCESS_POINT_SPAN = 2 * 1024 * 1024
+  };
+
+  struct AccessPoint
+  {
+    u64 uncompressed_offset;
+    u64 compressed_offset;
+    u32 bits;
+    std::unique_ptr<u8[]> window;
+  };
+
+  bool ReadStored(u64 offset, void* buffer, u32 size);
+  bool ReadDeflated(u64 offset, void* buffer, u32 size);
+
+  bool ResetStream(const AccessPoint& point);
+  void AddAccessPoint();
+
+  std::string GetIndexCacheFileName() const;
+  void LoadIndexCache();
+  void SaveIndexCache();
+
+  std::FILE* m_fp = nullptr;
+  std::string m_zip_filename;
+  std::string m_name;
+  u64 m_data_offset = 0;
+  u64 m_compressed_size = 0;
+  u64 m_size = 0;
+  u32 m_crc32 = 0;
+  bool m_deflated = false;
+
+  std::vector<AccessPoint> m_access_points;
+  size_t m_saved_access_point_count = 0;
+
+  // Current position of the decompressor. Output goes into a circular window, so it can be captured for access points.
+  z_stream m_stream = {};
+  bool m_stream_valid = false;
+  u64 m_stream_compressed_offset = 0;
+  u64 m_stream_uncompressed_offset = 0;
+  u32 m_window_position = 0;
+  u32 m_window_valid_bytes = 0;
+  std::unique_ptr<u8[]> m_window;
+  std::unique_ptr<u8[]> m_input_buffer;
+};
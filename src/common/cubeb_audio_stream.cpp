@@ -125,7 +125,7 @@ void CubebAudioStream::StateCallback(cubeb_stream* stream, void* user_ptr, cubeb
   this_ptr->m_paused = (state != CUBEB_STATE_STARTED);
 }
 
-void CubebAudioStream::BufferAvailable() {}
+void CubebAudioStream::FramesAvailable() {}
 
 void CubebAudioStream::DestroyContext()
 {
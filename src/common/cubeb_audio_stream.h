@@ -15,7 +15,7 @@ protected:
   bool OpenDevice() override;
   void PauseDevice(bool paused) override;
   void CloseDevice() override;
-  void BufferAvailable() override;
+  void FramesAvailable() override;
 
   void DestroyContext();
 
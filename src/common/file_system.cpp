@@ -385,6 +385,24 @@ std::FILE* OpenCFile(const char* filename, const char* mode)
 #endif
 }
 
+int FSeek64(std::FILE* fp, s64 offset, int whence)
+{
+#ifdef WIN32
+  return _fseeki64(fp, offset, whence);
+#else
+  return fseeko(fp, static_cast<off_t>(offset), whence);
+#endif
+}
+
+s64 FTell64(std::FILE* fp)
+{
+#ifdef WIN32
+  return static_cast<s64>(_ftelli64(fp));
+#else
+  return static_cast<s64>(ftello(fp));
+#endif
+}
+
 void BuildOSPath(char* Destination, u32 cbDestination, const char* Path)
 {
   u32 i;
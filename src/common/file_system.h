@@ -166,6 +166,10 @@ using ManagedCFilePtr = std::unique_ptr<std::FILE, void (*)(std::FILE*)>;
 ManagedCFilePtr OpenManagedCFile(const char* filename, const char* mode);
 std::FILE* OpenCFile(const char* filename, const char* mode);
 
+/// 64-bit safe fseek()/ftell(), the standard versions use long which is 32-bit on some platforms.
+int FSeek64(std::FILE* fp, s64 offset, int whence);
+s64 FTell64(std::FILE* fp);
+
 // creates a directory in the local filesystem
 // if the directory already exists, the return value will be true.
 // if Recursive is specified, all parent directories will be created
@@ -0,0 +1,173 @@
+#include "memory_mapped_file.h"
+#include "log.h"
+#include <algorithm>
+#include <cerrno>
+#include <limits>
+Log_SetChannel(MemoryMappedFile);
+
+#if defined(WIN32)
+#include "windows_headers.h"
+#include <string>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MemoryMappedFile::MemoryMappedFile() = default;
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+  Close();
+}
+
+#if defined(WIN32)
+
+bool MemoryMappedFile::Open(const char* filename)
+{
+  Close();
+
+  // filenames are UTF-8, which the ANSI API does not accept
+  const int wide_length = MultiByteToWideChar(CP_UTF8, 0, filename, -1, nullptr, 0);
+  if (wide_length <= 0)
+    return false;
+
+  std::wstring wide_filename(static_cast<size_t>(wide_length), L'\0');
+  if (MultiByteToWideChar(CP_UTF8, 0, filename, -1, wide_filename.data(), wide_length) != wide_length)
+    return false;
+
+  HANDLE file_handle = CreateFileW(wide_filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                   FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file_handle == INVALID_HANDLE_VALUE)
+    return false;
+
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file_handle, &file_size) || file_size.QuadPart <= 0 ||
+      static_cast<u64>(file_size.QuadPart) > std::numeric_limits<size_t>::max())
+  {
+    CloseHandle(file_handle);
+    return false;
+  }
+
+  HANDLE mapping_handle = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mapping_handle)
+  {
+    Log_WarningPrintf("CreateFileMapping() for '%s' failed: %u", filename, GetLastError());
+    CloseHandle(file_handle);
+    return false;
+  }
+
+  const void* data = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+  if (!data)
+  {
+    Log_WarningPrintf("MapViewOfFile() for '%s' failed: %u", filename, GetLastError());
+    CloseHandle(mapping_handle);
+    CloseHandle(file_handle);
+    return false;
+  }
+
+  m_file_handle = file_handle;
+  m_mapping_handle = mapping_handle;
+  m_data = static_cast<const u8*>(data);
+  m_size = static_cast<u64>(file_size.QuadPart);
+  return true;
+}
+
+void MemoryMappedFile::Close()
+{
+  if (m_data)
+  {
+    UnmapViewOfFile(m_data);
+    m_data = nullptr;
+  }
+  if (m_mapping_handle)
+  {
+    CloseHandle(m_mapping_handle);
+    m_mapping_handle = nullptr;
+  }
+  if (m_file_handle)
+  {
+    CloseHandle(m_file_handle);
+    m_file_handle = nullptr;
+  }
+
+  m_size = 0;
+  m_read_ahead_start = 0;
+  m_read_ahead_end = 0;
+}
+
+void MemoryMappedFile::ReadAhead(u64 offset)
+{
+  // FILE_FLAG_SEQUENTIAL_SCAN already drives the cache manager's read-ahead.
+}
+
+#else
+
+bool MemoryMappedFile::Open(const char* filename)
+{
+  Close();
+
+  const int fd = open(filename, O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0 ||
+      static_cast<u64>(st.st_size) > std::numeric_limits<size_t>::max())
+  {
+    close(fd);
+    return false;
+  }
+
+  const size_t size = static_cast<size_t>(st.st_size);
+  void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+  // the mapping holds its own reference to the file
+  close(fd);
+
+  if (data == MAP_FAILED)
+  {
+    Log_WarningPrintf("mmap() of '%s' failed: %d", filename, errno);
+    return false;
+  }
+
+  // disc images are mostly streamed, so let the kernel read ahead aggressively
+  madvise(data, size, MADV_SEQUENTIAL);
+
+  m_data = static_cast<const u8*>(data);
+  m_size = static_cast<u64>(size);
+  return true;
+}
+
+void MemoryMappedFile::Close()
+{
+  if (m_data)
+  {
+    munmap(const_cast<u8*>(m_data), static_cast<size_t>(m_size));
+    m_data = nullptr;
+  }
+
+  m_size = 0;
+  m_read_ahead_start = 0;
+  m_read_ahead_end = 0;
+}
+
+void MemoryMappedFile::ReadAhead(u64 offset)
+{
+  // re-issue the hint once we're halfway through the last window, or after a seek
+  if (offset >= m_read_ahead_start && offset < (m_read_ahead_start + (m_read_ahead_end - m_read_ahead_start) / 2))
+    return;
+
+  static const u64 page_size = static_cast<u64>(sysconf(_SC_PAGESIZE));
+  const u64 start = (offset / page_size) * page_size;
+  const u64 end = std::min(start + READ_AHEAD_SIZE, m_size);
+  if (start >= end)
+    return;
+
+  madvise(const_cast<u8*>(m_data) + start, static_cast<size_t>(end - start), MADV_WILLNEED);
+  m_read_ahead_start = start;
+  m_read_ahead_end = end;
+}
+
+#endif
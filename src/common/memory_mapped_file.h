@@ -0,0 +1,42 @@
+#pragma once
+#include "types.h"
+
+/// Read-only view of a whole file mapped into the address space.
+class MemoryMappedFile
+{
+public:
+  MemoryMappedFile();
+  ~MemoryMappedFile();
+
+  MemoryMappedFile(const MemoryMappedFile&) = delete;
+  MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+  bool IsOpen() const { return (m_data != nullptr); }
+  const u8* GetData() const { return m_data; }
+  u64 GetSize() const { return m_size; }
+
+  /// Maps the specified file. Fails for empty files, or if the file does not fit in the address space.
+  bool Open(const char* filename);
+  void Close();
+
+  /// Hints to the OS that the pages following offset will be needed soon. Only issues a new hint when offset
+  /// moves outside of the previously-requested window, so it is cheap to call for every read.
+  void ReadAhead(u64 offset);
+
+private:
+  enum : u64
+  {
+    READ_AHEAD_SIZE = 512 * 1024
+  };
+
+  const u8* m_data = nullptr;
+  u64 m_size = 0;
+
+  u64 m_read_ahead_start = 0;
+  u64 m_read_ahead_end = 0;
+
+#ifdef WIN32
+  void* m_file_handle = nullptr;
+  void* m_mapping_handle = nullptr;
+#endif
+};
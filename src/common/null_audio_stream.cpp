@@ -13,10 +13,10 @@ void NullAudioStream::PauseDevice(bool paused) {}
 
 void NullAudioStream::CloseDevice() {}
 
-void NullAudioStream::BufferAvailable()
+void NullAudioStream::FramesAvailable()
 {
-  // drop any buffer as soon as they're available
-  DropBuffer();
+  // drop any frames as soon as they're available
+  DropFrames(GetSamplesAvailable());
 }
 
 std::unique_ptr<AudioStream> AudioStream::CreateNullAudioStream()
@@ -20,7 +20,7 @@ public:
     Write
   };
 
-  StateWrapper(ByteStream* stream, Mode mode);
+  StateWrapper(ByteStream* stream, Mode mode, u32 version);
   StateWrapper(const StateWrapper&) = delete;
   ~StateWrapper();
 
@@ -31,6 +31,9 @@ public:
   Mode GetMode() const { return m_mode; }
   void SetMode(Mode mode) { m_mode = mode; }
 
+  /// Version of the state data, for handling states saved by older versions.
+  u32 GetVersion() const { return m_version; }
+
   /// Overload for integral or floating-point types. Writes bytes as-is.
   template<typename T, std::enable_if_t<std::is_integral_v<T> || std::is_floating_point_v<T>, int> = 0>
   void Do(T* value_ptr)
@@ -85,18 +88,30 @@ public:
     }
   }
 
+  /// Types which Do() writes as their raw bytes, so arrays of them can be transferred in one go. bool is excluded,
+  /// since reading normalizes it.
+  template<typename T>
+  static constexpr bool IsRawBytesType =
+    (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) || std::is_enum_v<T>;
+
   template<typename T>
   void DoArray(T* values, size_t count)
   {
-    for (size_t i = 0; i < count; i++)
-      Do(&values[i]);
+    if constexpr (IsRawBytesType<T>)
+    {
+      DoBytes(values, sizeof(T) * count);
+    }
+    else
+    {
+      for (size_t i = 0; i < count; i++)
+        Do(&values[i]);
+    }
   }
 
-  template<typename T>
+  template<typename T, std::enable_if_t<std::is_pod_v<T>, int> = 0>
   void DoPODArray(T* values, size_t count)
   {
-    for (size_t i = 0; i < count; i++)
-      DoPOD(&values[i]);
+    DoBytes(values, sizeof(T) * count);
   }
 
   void DoBytes(void* data, size_t length);
@@ -163,6 +178,13 @@ public:
       data->PushRange(temp, size);
       delete[] temp;
     }
+    else if constexpr (IsRawBytesType<T>)
+    {
+      // The queue wraps around, so it's at most two contiguous ranges.
+      const u32 contiguous_size = data->GetContiguousSize();
+      DoArray(data->GetFrontPointer(), contiguous_size);
+      DoArray(data->GetDataPointer(), size - contiguous_size);
+    }
     else
     {
       for (u32 i = 0; i < size; i++)
@@ -178,5 +200,6 @@ public:
 private:
   ByteStream* m_stream;
   Mode m_mode;
+  u32 m_version;
   bool m_error = false;
 };
@@ -95,7 +95,12 @@ u32 AnalogController::GetVibrationMotorCount() const
 float AnalogController::GetVibrationMotorStrength(u32 motor)
 {
   DebugAssert(motor < NUM_MOTORS);
-  return static_cast<float>(m_motor_state[motor]) * (1.0f / 255.0f);
+  return static_cast<float>(m_output_motor_state[motor]) * (1.0f / 255.0f);
+}
+
+void AnalogController::SetRunningAhead(bool running_ahead)
+{
+  m_running_ahead = running_ahead;
 }
 
 void AnalogController::ResetTransferState()
@@ -128,6 +133,8 @@ void AnalogController::SetMotorState(u8 motor, u8 value)
 {
   DebugAssert(motor < NUM_MOTORS);
   m_motor_state[motor] = value;
+  if (!m_running_ahead)
+    m_output_motor_state[motor] = value;
 }
 
 bool AnalogController::Transfer(const u8 data_in, u8* data_out)
@@ -67,6 +67,7 @@ public:
 
   u32 GetVibrationMotorCount() const override;
   float GetVibrationMotorStrength(u32 motor) override;
+  void SetRunningAhead(bool running_ahead) override;
 
 private:
   using MotorState = std::array<u8, NUM_MOTORS>;
@@ -139,5 +140,9 @@ private:
 
   MotorState m_motor_state{};
 
+  // Motor state reported to the host, which isn't updated by frames run ahead.
+  MotorState m_output_motor_state{};
+  bool m_running_ahead = false;
+
   State m_state = State::Idle;
 };
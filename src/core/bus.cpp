@@ -15,7 +15,9 @@
 #include "sio.h"
 #include "spu.h"
 #include "timers.h"
+#include <algorithm>
 #include <cstdio>
+#include <cstring>
 Log_SetChannel(Bus);
 
 #define FIXUP_WORD_READ_OFFSET(offset) ((offset) & ~u32(3))
@@ -66,15 +68,83 @@ void Bus::Reset()
   RecalculateMemoryTimings();
 }
 
-bool Bus::DoState(StateWrapper& sw)
+bool Bus::DoState(StateWrapper& sw, std::vector<u8>* ram_copy)
 {
   sw.Do(&m_exp1_access_time);
   sw.Do(&m_exp2_access_time);
   sw.Do(&m_bios_access_time);
   sw.Do(&m_cdrom_access_time);
   sw.Do(&m_spu_access_time);
-  sw.DoBytes(m_ram.data(), m_ram.size());
-  sw.DoBytes(m_bios.data(), m_bios.size());
+  if (sw.IsReading())
+  {
+    // Compiled code is kept across state loads. Only the pages whose contents the state changes are invalidated, and
+    // the whole cache is only flushed if the BIOS differs (e.g. a different image, or different patches). Pages with
+    // code are read separately and compared against the current contents, everything else is read straight into RAM.
+    if (ram_copy && ram_copy->size() != RAM_SIZE)
+      return false;
+
+    std::array<u8, CPU_CODE_CACHE_PAGE_SIZE> page;
+    u32 page_index = 0;
+    while (page_index < CPU_CODE_CACHE_PAGE_COUNT)
+    {
+      u8* ram_ptr = &m_ram[page_index * CPU_CODE_CACHE_PAGE_SIZE];
+      if (!m_ram_code_bits[page_index])
+      {
+        u32 page_count = 1;
+        while ((page_index + page_count) < CPU_CODE_CACHE_PAGE_COUNT && !m_ram_code_bits[page_index + page_count])
+          page_count++;
+
+        const u32 size = page_count * CPU_CODE_CACHE_PAGE_SIZE;
+        if (ram_copy)
+          std::memcpy(ram_ptr, ram_copy->data() + (page_index * CPU_CODE_CACHE_PAGE_SIZE), size);
+        else
+          sw.DoBytes(ram_ptr, size);
+
+        page_index += page_count;
+        continue;
+      }
+
+      const u8* new_page_ptr = page.data();
+      if (ram_copy)
+        new_page_ptr = ram_copy->data() + (page_index * CPU_CODE_CACHE_PAGE_SIZE);
+      else
+        sw.DoBytes(page.data(), CPU_CODE_CACHE_PAGE_SIZE);
+
+      if (std::memcmp(ram_ptr, new_page_ptr, CPU_CODE_CACHE_PAGE_SIZE) != 0)
+      {
+        std::memcpy(ram_ptr, new_page_ptr, CPU_CODE_CACHE_PAGE_SIZE);
+        DoInvalidateCodeCache(page_index);
+      }
+
+      page_index++;
+    }
+
+    bool bios_changed = false;
+    for (u32 offset = 0; offset < BIOS_SIZE; offset += CPU_CODE_CACHE_PAGE_SIZE)
+    {
+      sw.DoBytes(page.data(), CPU_CODE_CACHE_PAGE_SIZE);
+      if (std::memcmp(&m_bios[offset], page.data(), CPU_CODE_CACHE_PAGE_SIZE) != 0)
+      {
+        std::memcpy(&m_bios[offset], page.data(), CPU_CODE_CACHE_PAGE_SIZE);
+        bios_changed = true;
+      }
+    }
+
+    if (bios_changed)
+    {
+      Log_DevPrintf("BIOS changed in save state, flushing code cache");
+      m_cpu_code_cache->Flush();
+    }
+  }
+  else
+  {
+    if (ram_copy)
+      ram_copy->assign(m_ram.begin(), m_ram.end());
+    else
+      sw.DoBytes(m_ram.data(), m_ram.size());
+    sw.DoBytes(m_bios.data(), m_bios.size());
+  }
+
   sw.DoArray(m_MEMCTRL.regs, countof(m_MEMCTRL.regs));
   sw.Do(&m_ram_size_reg);
   sw.Do(&m_tty_line_buffer);
@@ -166,16 +236,32 @@ TickCount Bus::WriteWords(PhysicalMemoryAddress address, const u32* words, u32 w
     return total_ticks;
   }
 
+  InvalidateCodeCacheForWrite(address, word_count);
+  std::memcpy(&m_ram[address], words, sizeof(u32) * word_count);
+  return static_cast<TickCount>(word_count + ((word_count + 15) / 16));
+}
+
+u32* Bus::GetRAMWordsForWrite(PhysicalMemoryAddress address, u32 word_count)
+{
+  if ((address & 3) != 0 || address + (word_count * sizeof(u32)) > (RAM_BASE + RAM_SIZE))
+    return nullptr;
+
+  InvalidateCodeCacheForWrite(address, word_count);
+  return reinterpret_cast<u32*>(&m_ram[address]);
+}
+
+void Bus::InvalidateCodeCacheForWrite(PhysicalMemoryAddress address, u32 word_count)
+{
+  if (word_count == 0)
+    return;
+
   const u32 start_page = address / CPU_CODE_CACHE_PAGE_SIZE;
-  const u32 end_page = (address + word_count * sizeof(u32)) / CPU_CODE_CACHE_PAGE_SIZE;
+  const u32 end_page = (address + word_count * sizeof(u32) - 1) / CPU_CODE_CACHE_PAGE_SIZE;
   for (u32 page = start_page; page <= end_page; page++)
   {
     if (m_ram_code_bits[page])
       DoInvalidateCodeCache(page);
   }
-
-  std::memcpy(&m_ram[address], words, sizeof(u32) * word_count);
-  return static_cast<TickCount>(word_count + ((word_count + 15) / 16));
 }
 
 void Bus::SetExpansionROM(std::vector<u8> data)
@@ -33,7 +33,8 @@ public:
   void Initialize(CPU::Core* cpu, CPU::CodeCache* cpu_code_cache, DMA* dma, InterruptController* interrupt_controller,
                   GPU* gpu, CDROM* cdrom, Pad* pad, Timers* timers, SPU* spu, MDEC* mdec, SIO* sio);
   void Reset();
-  bool DoState(StateWrapper& sw);
+  /// If ram_copy is set, RAM is transferred to/from it instead of the stream.
+  bool DoState(StateWrapper& sw, std::vector<u8>* ram_copy);
 
   bool ReadByte(PhysicalMemoryAddress address, u8* value);
   bool ReadHalfWord(PhysicalMemoryAddress address, u16* value);
@@ -49,6 +50,10 @@ public:
   TickCount ReadWords(PhysicalMemoryAddress address, u32* words, u32 word_count);
   TickCount WriteWords(PhysicalMemoryAddress address, const u32* words, u32 word_count);
 
+  /// Returns a pointer for writing words directly into RAM, or nullptr if the range is not contiguous RAM. Any code in
+  /// the range is invalidated, so the caller must write all of the words before executing any more instructions.
+  u32* GetRAMWordsForWrite(PhysicalMemoryAddress address, u32 word_count);
+
   void SetExpansionROM(std::vector<u8> data);
   void SetBIOS(const std::vector<u8>& image);
 
@@ -242,6 +247,7 @@ private:
   void DoWriteSPU(MemoryAccessSize size, u32 offset, u32 value);
 
   void DoInvalidateCodeCache(u32 page_index);
+  void InvalidateCodeCacheForWrite(PhysicalMemoryAddress address, u32 word_count);
 
   CPU::Core* m_cpu = nullptr;
   CPU::CodeCache* m_cpu_code_cache = nullptr;
@@ -262,8 +268,8 @@ private:
   std::array<TickCount, 3> m_spu_access_time = {};
 
   std::bitset<CPU_CODE_CACHE_PAGE_COUNT> m_ram_code_bits{};
-  std::array<u8, RAM_SIZE> m_ram{};   // 2MB RAM
-  std::array<u8, BIOS_SIZE> m_bios{}; // 512K BIOS ROM
+  alignas(16) std::array<u8, RAM_SIZE> m_ram{}; // 2MB RAM
+  std::array<u8, BIOS_SIZE> m_bios{};           // 512K BIOS ROM
   std::vector<u8> m_exp1_rom;
 
   MEMCTRL m_MEMCTRL = {};
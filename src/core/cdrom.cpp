@@ -1,5 +1,6 @@
 #include "cdrom.h"
 #include "common/cd_image.h"
+#include "common/cpu_detect.h"
 #include "common/log.h"
 #include "common/state_wrapper.h"
 #include "dma.h"
@@ -7,6 +8,11 @@
 #include "interrupt_controller.h"
 #include "spu.h"
 #include "system.h"
+#if defined(CPU_X64)
+#include <emmintrin.h>
+#elif defined(CPU_AARCH64)
+#include <arm_neon.h>
+#endif
 Log_SetChannel(CDROM);
 
 CDROM::CDROM()
@@ -30,8 +36,8 @@ void CDROM::Initialize(System* system, DMA* dma, InterruptController* interrupt_
 
 void CDROM::Reset()
 {
-  if (m_media)
-    m_media->Seek(0);
+  m_current_lba = 0;
+  m_reader.QueueReadSector(m_current_lba);
 
   SoftReset();
 }
@@ -121,8 +127,7 @@ bool CDROM::DoState(StateWrapper& sw)
   sw.Do(&m_data_fifo);
   sw.Do(&m_sector_buffer);
 
-  u32 media_lba = m_media ? m_media->GetPositionOnDisc() : 0;
-  sw.Do(&media_lba);
+  sw.Do(&m_current_lba);
 
   if (sw.IsReading())
   {
@@ -130,10 +135,17 @@ bool CDROM::DoState(StateWrapper& sw)
     m_drive_event->SetState(!IsDriveIdle());
 
     // load up media if we had something in there before
-    if (m_media && !m_media->Seek(media_lba))
+    if (HasMedia())
     {
-      Log_ErrorPrint("Failed to seek CD media from save state. Ejecting.");
-      RemoveMedia();
+      if (m_reader.GetMedia()->GetTrackNumberForDiscPosition(m_current_lba) == 0)
+      {
+        Log_ErrorPrint("Failed to seek CD media from save state. Ejecting.");
+        RemoveMedia();
+      }
+      else
+      {
+        m_reader.QueueReadSector(m_current_lba);
+      }
     }
   }
 
@@ -142,10 +154,10 @@ bool CDROM::DoState(StateWrapper& sw)
 
 std::string CDROM::GetMediaFileName() const
 {
-  if (!m_media)
+  if (!HasMedia())
     return std::string();
 
-  return m_media->GetFileName();
+  return m_reader.GetMediaFileName();
 }
 
 void CDROM::InsertMedia(std::unique_ptr<CDImage> media)
@@ -153,16 +165,18 @@ void CDROM::InsertMedia(std::unique_ptr<CDImage> media)
   if (HasMedia())
     RemoveMedia();
 
-  m_media = std::move(media);
+  // the image starts at the beginning of the first track
+  m_current_lba = media->GetPositionOnDisc();
+  m_reader.SetMedia(std::move(media));
 }
 
 void CDROM::RemoveMedia()
 {
-  if (!m_media)
+  if (!HasMedia())
     return;
 
   Log_InfoPrintf("Removing CD...");
-  m_media.reset();
+  m_reader.RemoveMedia();
 
   m_secondary_status.shell_open = true;
 
@@ -176,6 +190,16 @@ void CDROM::RemoveMedia()
   }
 }
 
+void CDROM::UpdateReadSpeed()
+{
+  if (m_drive_state != DriveState::Reading)
+    return;
+
+  const TickCount ticks = GetTicksForRead();
+  if (m_drive_event->GetInterval() != ticks)
+    m_drive_event->SetInterval(ticks);
+}
+
 u8 CDROM::ReadRegister(u32 offset)
 {
   switch (offset)
@@ -495,21 +519,41 @@ TickCount CDROM::GetAckDelayForCommand() const
     return default_ack_delay;
 }
 
+u8 CDROM::GetCurrentTrackNumber() const
+{
+  // past the end of the disc counts as the last track
+  const CDImage* media = m_reader.GetMedia();
+  const u32 track_number = media->GetTrackNumberForDiscPosition(m_current_lba);
+  return Truncate8((track_number != 0) ? track_number : media->GetTrackCount());
+}
+
+bool CDROM::IsReadSpeedupActive() const
+{
+  // Only data reads are sped up. XA-ADPCM and CDDA are streamed to the SPU, so they have to stay at the real rate.
+  return m_system->GetSettings().cdrom_read_speedup != 1 && m_drive_state == DriveState::Reading &&
+         !m_mode.xa_enable;
+}
+
 TickCount CDROM::GetTicksForRead() const
 {
-  return m_mode.double_speed ? (MASTER_CLOCK / 150) : (MASTER_CLOCK / 75);
+  const TickCount ticks = m_mode.double_speed ? (MASTER_CLOCK / 150) : (MASTER_CLOCK / 75);
+  if (!IsReadSpeedupActive())
+    return ticks;
+
+  const u32 speedup = m_system->GetSettings().cdrom_read_speedup;
+  return (speedup == 0) ? MIN_SPEEDUP_READ_TICKS : std::max<TickCount>(ticks / static_cast<TickCount>(speedup), 1);
 }
 
 TickCount CDROM::GetTicksForSeek() const
 {
-  const CDImage::LBA current_lba = m_secondary_status.motor_on ? m_media->GetPositionOnDisc() : 0;
+  const CDImage::LBA current_lba = m_secondary_status.motor_on ? m_current_lba : 0;
   const CDImage::LBA new_lba = m_setloc_position.ToLBA();
   const u32 lba_diff = static_cast<u32>((new_lba > current_lba) ? (new_lba - current_lba) : (current_lba - new_lba));
 
   // const TickCount ticks = static_cast<TickCount>(20000 + lba_diff * 100);
 
   // Formula from Mednafen.
-  TickCount ticks = std::max<TickCount>(20000, lba_diff * MASTER_CLOCK * 1000 / (72 * 60 * 75) / 1000);
+  TickCount ticks = std::max<TickCount>(MIN_SEEK_TICKS, lba_diff * MASTER_CLOCK * 1000 / (72 * 60 * 75) / 1000);
   if (!m_secondary_status.motor_on)
     ticks += MASTER_CLOCK;
   else if (m_drive_state == DriveState::Idle) // paused
@@ -517,6 +561,14 @@ TickCount CDROM::GetTicksForSeek() const
   if (lba_diff >= 2550)
     ticks += static_cast<TickCount>(u64(MASTER_CLOCK) * 300 / 1000);
 
+  // The speedup applies to seeks regardless of what's read afterwards, since nothing is streamed while seeking.
+  // Keep the minimum so that the second response still comes after the first.
+  const u32 speedup = m_system->GetSettings().cdrom_read_speedup;
+  if (speedup == 0)
+    ticks = MIN_SEEK_TICKS;
+  else if (speedup != 1)
+    ticks = std::max<TickCount>(ticks / static_cast<TickCount>(speedup), MIN_SEEK_TICKS);
+
   Log_DevPrintf("Seek time for %u LBAs: %d", lba_diff, ticks);
   return ticks;
 }
@@ -558,7 +610,7 @@ void CDROM::ExecuteCommand()
       SendACKAndStat();
 
       // shell open bit is cleared after sending the status
-      if (m_media)
+      if (HasMedia())
         m_secondary_status.shell_open = false;
 
       EndCommand();
@@ -652,7 +704,7 @@ void CDROM::ExecuteCommand()
     {
       const bool logical = (m_command == Command::SeekL);
       Log_DebugPrintf("CDROM %s command", logical ? "SeekL" : "SeekP");
-      if (!m_media)
+      if (!HasMedia())
       {
         SendErrorResponse(0x80);
       }
@@ -670,7 +722,7 @@ void CDROM::ExecuteCommand()
     case Command::ReadS:
     {
       Log_DebugPrintf("CDROM read command");
-      if (!m_media)
+      if (!HasMedia())
       {
         SendErrorResponse(0x80);
       }
@@ -689,7 +741,7 @@ void CDROM::ExecuteCommand()
       u8 track = m_param_fifo.IsEmpty() ? 0 : m_param_fifo.Peek(0);
       Log_DebugPrintf("CDROM play command, track=%u", track);
 
-      if (!m_media)
+      if (!HasMedia())
       {
         SendErrorResponse(0x80);
       }
@@ -825,11 +877,11 @@ void CDROM::ExecuteCommand()
     case Command::GetTN:
     {
       Log_DebugPrintf("CDROM GetTN command");
-      if (m_media)
+      if (HasMedia())
       {
         m_response_fifo.Push(m_secondary_status.bits);
-        m_response_fifo.Push(BinaryToBCD(Truncate8(m_media->GetTrackNumber())));
-        m_response_fifo.Push(BinaryToBCD(Truncate8(m_media->GetTrackCount())));
+        m_response_fifo.Push(BinaryToBCD(GetCurrentTrackNumber()));
+        m_response_fifo.Push(BinaryToBCD(Truncate8(m_reader.GetMedia()->GetTrackCount())));
         SetInterrupt(Interrupt::ACK);
       }
       else
@@ -847,11 +899,11 @@ void CDROM::ExecuteCommand()
       Assert(m_param_fifo.GetSize() >= 1);
       const u8 track = PackedBCDToBinary(m_param_fifo.Peek());
 
-      if (!m_media)
+      if (!HasMedia())
       {
         SendErrorResponse(0x80);
       }
-      else if (track > m_media->GetTrackCount())
+      else if (track > m_reader.GetMedia()->GetTrackCount())
       {
         SendErrorResponse(0x10);
       }
@@ -859,9 +911,9 @@ void CDROM::ExecuteCommand()
       {
         CDImage::Position pos;
         if (track == 0)
-          pos = CDImage::Position::FromLBA(m_media->GetLBACount());
+          pos = CDImage::Position::FromLBA(m_reader.GetMedia()->GetLBACount());
         else
-          pos = m_media->GetTrackStartMSFPosition(track);
+          pos = m_reader.GetMedia()->GetTrackStartMSFPosition(track);
 
         m_response_fifo.Push(m_secondary_status.bits);
         m_response_fifo.Push(BinaryToBCD(Truncate8(pos.minute)));
@@ -1018,8 +1070,8 @@ void CDROM::BeginReading(TickCount ticks_late)
   // TODO: Should the sector buffer be cleared here?
   m_sector_buffer.clear();
 
-  const TickCount ticks = GetTicksForRead();
   m_drive_state = DriveState::Reading;
+  const TickCount ticks = GetTicksForRead();
   m_drive_event->SetInterval(ticks);
   m_drive_event->Schedule(ticks - ticks_late);
 }
@@ -1034,13 +1086,13 @@ void CDROM::BeginPlaying(u8 track_bcd, TickCount ticks_late)
   if (track_bcd != 0)
   {
     // play specific track?
-    if (track_bcd > m_media->GetTrackCount())
+    if (track_bcd > m_reader.GetMedia()->GetTrackCount())
     {
       // restart current track
-      track_bcd = BinaryToBCD(Truncate8(m_media->GetTrackNumber()));
+      track_bcd = BinaryToBCD(GetCurrentTrackNumber());
     }
 
-    m_setloc_position = m_media->GetTrackStartMSFPosition(PackedBCDToBinary(track_bcd));
+    m_setloc_position = m_reader.GetMedia()->GetTrackStartMSFPosition(PackedBCDToBinary(track_bcd));
     m_setloc_pending = true;
   }
 
@@ -1056,8 +1108,8 @@ void CDROM::BeginPlaying(u8 track_bcd, TickCount ticks_late)
   // TODO: Should the sector buffer be cleared here?
   m_sector_buffer.clear();
 
-  const TickCount ticks = GetTicksForRead();
   m_drive_state = DriveState::Playing;
+  const TickCount ticks = GetTicksForRead();
   m_drive_event->SetInterval(ticks);
   m_drive_event->Schedule(ticks - ticks_late);
 }
@@ -1084,11 +1136,10 @@ void CDROM::BeginSeeking(bool logical, bool read_after_seek, bool play_after_see
   m_drive_state = logical ? DriveState::SeekingLogical : DriveState::SeekingPhysical;
   m_drive_event->SetIntervalAndSchedule(seek_time);
 
-  // Read sub-q early.. this is because we're not reading sectors while seeking.
-  // Fixes music looping in Spyro.
-  CDImage::SubChannelQ subq;
-  if (m_media->Seek(m_seek_position) && m_media->ReadSubChannelQ(&subq) && subq.IsCRCValid())
-    m_last_subq = subq;
+  // Start reading ahead from the new position while the seek is in progress. Sub-Q is picked up from the buffered
+  // sector when the seek completes, by which point it has usually been read.
+  m_current_lba = m_seek_position.ToLBA();
+  m_reader.QueueReadSector(m_current_lba);
 }
 
 void CDROM::DoSpinUpComplete()
@@ -1111,7 +1162,12 @@ void CDROM::DoSeekComplete(TickCount ticks_late)
   m_secondary_status.ClearActiveBits();
   m_sector_buffer.clear();
 
-  // seek and update sub-q for ReadP command
+  // update sub-q for ReadP command from the sector read ahead during the seek. Fixes music looping in Spyro.
+  CDImage::SubChannelQ subq;
+  const u8* raw_sector = m_reader.ReadSector(m_current_lba, &subq);
+  if (raw_sector && subq.IsCRCValid())
+    m_last_subq = subq;
+
   const auto [seek_mm, seek_ss, seek_ff] = m_seek_position.ToBCD();
   bool seek_okay = (m_last_subq.absolute_minute_bcd == seek_mm && m_last_subq.absolute_second_bcd == seek_ss &&
                     m_last_subq.absolute_frame_bcd == seek_ff);
@@ -1120,9 +1176,7 @@ void CDROM::DoSeekComplete(TickCount ticks_late)
     // check for data header for logical seeks
     if (logical)
     {
-      u8 raw_sector[CDImage::RAW_SECTOR_SIZE];
-      seek_okay &= m_media->ReadRawSector(raw_sector);
-      seek_okay &= m_media->Seek(m_media->GetPositionOnDisc() - 1);
+      seek_okay &= (raw_sector != nullptr);
       if (seek_okay)
       {
         ProcessDataSectorHeader(raw_sector, false);
@@ -1188,7 +1242,8 @@ void CDROM::DoStopComplete()
   m_secondary_status.motor_on = false;
   m_sector_buffer.clear();
 
-  m_media->Seek(0);
+  m_current_lba = 0;
+  m_reader.QueueReadSector(m_current_lba);
 
   m_async_response_fifo.Clear();
   m_async_response_fifo.Push(m_secondary_status.bits);
@@ -1225,11 +1280,26 @@ void CDROM::DoTOCRead()
 
 void CDROM::DoSectorRead()
 {
+  if (m_system->GetSettings().cdrom_read_speedup != 1 && m_drive_state == DriveState::Reading)
+  {
+    // The speedup depends on the mode, which can change mid-read, e.g. when a game switches to XA streaming.
+    const TickCount ticks = GetTicksForRead();
+    if (m_drive_event->GetInterval() != ticks)
+      m_drive_event->SetInterval(ticks);
+
+    // When reading faster than the real drive, the CPU may not have acknowledged the previous sector yet. Hold the
+    // drive on the current sector until it does, rather than dropping the data interrupt.
+    if (IsReadSpeedupActive() && HasPendingAsyncInterrupt())
+      return;
+  }
+
   // TODO: Error handling
   // TODO: Check SubQ checksum.
+  // Sectors are normally already buffered by the reader thread, so this only blocks if it fell behind.
   CDImage::SubChannelQ subq;
-  if (!m_media->ReadSubChannelQ(&subq))
-    Panic("SubChannel Q read failed");
+  const u8* raw_sector = m_reader.ReadSector(m_current_lba, &subq);
+  if (!raw_sector)
+    Panic("Sector read failed");
 
   const bool is_data_sector = subq.control.data;
   m_secondary_status.playing_cdda = !is_data_sector;
@@ -1244,8 +1314,7 @@ void CDROM::DoSectorRead()
     else if (m_mode.auto_pause && subq.track_number_bcd != m_play_track_number_bcd)
     {
       // we don't want to update the position if the track changes, so we check it before reading the actual sector.
-      Log_DevPrintf("Auto pause at the end of track %u (LBA %u)", m_play_track_number_bcd,
-                    m_media->GetPositionOnDisc());
+      Log_DevPrintf("Auto pause at the end of track %u (LBA %u)", m_play_track_number_bcd, m_current_lba);
 
       ClearAsyncInterrupt();
       m_async_response_fifo.Push(m_secondary_status.bits);
@@ -1258,9 +1327,7 @@ void CDROM::DoSectorRead()
     }
   }
 
-  u8 raw_sector[CDImage::RAW_SECTOR_SIZE];
-  if (!m_media->ReadRawSector(raw_sector))
-    Panic("Sector read failed");
+  m_current_lba++;
 
   if (subq.IsCRCValid())
   {
@@ -1280,14 +1347,14 @@ void CDROM::DoSectorRead()
     }
     else
     {
-      Log_WarningPrintf("Skipping sector %u as it is a %s sector and we're not %s", m_media->GetPositionOnDisc() - 1,
+      Log_WarningPrintf("Skipping sector %u as it is a %s sector and we're not %s", m_current_lba - 1,
                         is_data_sector ? "data" : "audio", is_data_sector ? "reading" : "playing");
     }
   }
   else
   {
-    const CDImage::Position pos(CDImage::Position::FromLBA(m_media->GetPositionOnDisc() - 1));
-    Log_DevPrintf("Skipping sector %u [%02u:%02u:%02u] due to invalid subchannel Q", m_media->GetPositionOnDisc() - 1,
+    const CDImage::Position pos(CDImage::Position::FromLBA(m_current_lba - 1));
+    Log_DevPrintf("Skipping sector %u [%02u:%02u:%02u] due to invalid subchannel Q", m_current_lba - 1,
                   pos.minute, pos.second, pos.frame);
   }
 }
@@ -1304,7 +1371,7 @@ void CDROM::ProcessDataSector(const u8* raw_sector, const CDImage::SubChannelQ&
 {
   ProcessDataSectorHeader(raw_sector, true);
 
-  Log_DevPrintf("Read sector %u: mode %u submode 0x%02X", m_media->GetPositionOnDisc() - 1,
+  Log_DevPrintf("Read sector %u: mode %u submode 0x%02X", m_current_lba - 1,
                 ZeroExtend32(m_last_sector_header.sector_mode), ZeroExtend32(m_last_sector_subheader.submode.bits));
 
   if (m_mode.xa_enable && m_last_sector_header.sector_mode == 2)
@@ -1363,7 +1430,8 @@ void CDROM::ProcessDataSector(const u8* raw_sector, const CDImage::SubChannelQ&
   SetAsyncInterrupt(Interrupt::INT1);
 }
 
-static std::array<std::array<s16, 29>, 7> s_zigzag_table = {
+// Padded to 32 taps with zeros, so they can be processed eight at a time.
+alignas(16) static std::array<std::array<s16, 32>, 7> s_zigzag_table = {
   {{0,      0x0,     0x0,     0x0,    0x0,     -0x0002, 0x000A,  -0x0022, 0x0041, -0x0054,
     0x0034, 0x0009,  -0x010A, 0x0400, -0x0A78, 0x234C,  0x6794,  -0x1780, 0x0BCD, -0x0623,
     0x0350, -0x016D, 0x006B,  0x000A, -0x0010, 0x0011,  -0x0008, 0x0003,  -0x0001},
@@ -1386,13 +1454,67 @@ static std::array<std::array<s16, 29>, 7> s_zigzag_table = {
     0x3C07,  0x53E0,  -0x16FA, 0x0AFA, -0x0548, 0x027B,  -0x00EB, 0x001A,  0x002B, -0x0023,
     0x0010,  -0x0008, 0x0002,  0x0,    0x0,     0x0,     0x0,     0x0,     0x0}}};
 
-static s16 ZigZagInterpolate(const s16* ringbuf, const s16* table, u8 p)
+#if defined(CPU_X64)
+
+static ALWAYS_INLINE __m128i DivideProducts32768(__m128i products)
 {
+  // Divide rounds towards zero, so negative values need a bias before shifting.
+  return _mm_srai_epi32(_mm_add_epi32(products, _mm_srli_epi32(_mm_srai_epi32(products, 31), 17)), 15);
+}
+
+#elif defined(CPU_AARCH64)
+
+static ALWAYS_INLINE int32x4_t DivideProducts32768(int32x4_t products)
+{
+  const uint32x4_t bias = vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(products, 31)), 17);
+  return vshrq_n_s32(vaddq_s32(products, vreinterpretq_s32_u32(bias)), 15);
+}
+
+#endif
+
+static s16 ZigZagInterpolate(const s16* history, const s16* table)
+{
+  // Each product is divided separately before summing, so the sum can't be shifted down as a whole.
+#if defined(CPU_X64)
+  __m128i sum = _mm_setzero_si128();
+  for (u32 i = 0; i < 32; i += 8)
+  {
+    const __m128i samples = _mm_load_si128(reinterpret_cast<const __m128i*>(&history[i]));
+    const __m128i coefficients = _mm_load_si128(reinterpret_cast<const __m128i*>(&table[i]));
+    const __m128i products_low = _mm_mullo_epi16(samples, coefficients);
+    const __m128i products_high = _mm_mulhi_epi16(samples, coefficients);
+    sum = _mm_add_epi32(sum, DivideProducts32768(_mm_unpacklo_epi16(products_low, products_high)));
+    sum = _mm_add_epi32(sum, DivideProducts32768(_mm_unpackhi_epi16(products_low, products_high)));
+  }
+
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+  return static_cast<s16>(std::clamp<s32>(_mm_cvtsi128_si32(sum), -0x8000, 0x7FFF));
+#elif defined(CPU_AARCH64)
+  int32x4_t sum = vdupq_n_s32(0);
+  for (u32 i = 0; i < 32; i += 8)
+  {
+    const int16x8_t samples = vld1q_s16(&history[i]);
+    const int16x8_t coefficients = vld1q_s16(&table[i]);
+    sum = vaddq_s32(sum, DivideProducts32768(vmull_s16(vget_low_s16(samples), vget_low_s16(coefficients))));
+    sum = vaddq_s32(sum, DivideProducts32768(vmull_s16(vget_high_s16(samples), vget_high_s16(coefficients))));
+  }
+
+  return static_cast<s16>(std::clamp<s32>(vaddvq_s32(sum), -0x8000, 0x7FFF));
+#else
   s32 sum = 0;
-  for (u8 i = 0; i < 29; i++)
-    sum += (s32(ringbuf[(p - i) & 0x1F]) * s32(table[i])) / 0x8000;
+  for (u32 i = 0; i < 29; i++)
+    sum += (s32(history[i]) * s32(table[i])) / 0x8000;
 
   return static_cast<s16>(std::clamp<s32>(sum, -0x8000, 0x7FFF));
+#endif
+}
+
+static ALWAYS_INLINE void GetZigZagHistory(const s16* ringbuf, u8 p, s16* history)
+{
+  // Unwrap the ring buffer, newest first, so the taps line up with the tables.
+  for (u32 i = 0; i < 32; i++)
+    history[i] = ringbuf[(p - i) & 0x1F];
 }
 
 static constexpr s32 ApplyVolume(s16 sample, u8 volume)
@@ -1433,10 +1555,19 @@ static void ResampleXAADPCM(const s16* samples_in, u32 num_samples_in, SPU* spu,
       if (sixstep == 0)
       {
         sixstep = 6;
+
+        // All seven outputs use the same window of the ring buffer.
+        alignas(16) std::array<s16, 32> left_history;
+        alignas(16) std::array<s16, 32> right_history;
+        GetZigZagHistory(left_ringbuf, p, left_history.data());
+        if constexpr (STEREO)
+          GetZigZagHistory(right_ringbuf, p, right_history.data());
+
         for (u32 j = 0; j < 7; j++)
         {
-          const s16 left_interp = ZigZagInterpolate(left_ringbuf, s_zigzag_table[j].data(), p);
-          const s16 right_interp = STEREO ? ZigZagInterpolate(right_ringbuf, s_zigzag_table[j].data(), p) : left_interp;
+          const s16 left_interp = ZigZagInterpolate(left_history.data(), s_zigzag_table[j].data());
+          const s16 right_interp =
+            STEREO ? ZigZagInterpolate(right_history.data(), s_zigzag_table[j].data()) : left_interp;
 
           const s16 left_out = SaturateVolume(ApplyVolume(left_interp, volume_matrix[0][0]) +
                                               ApplyVolume(right_interp, volume_matrix[1][0]));
@@ -1503,7 +1634,7 @@ void CDROM::ProcessXAADPCMSector(const u8* raw_sector, const CDImage::SubChannel
 void CDROM::ProcessCDDASector(const u8* raw_sector, const CDImage::SubChannelQ& subq)
 {
   // For CDDA sectors, the whole sector contains the audio data.
-  Log_DevPrintf("Read sector %u as CDDA", m_media->GetPositionOnDisc());
+  Log_DevPrintf("Read sector %u as CDDA", m_current_lba);
 
   if (m_mode.report_audio)
   {
@@ -1594,16 +1725,24 @@ void CDROM::DrawDebugWindow()
   // draw voice states
   if (ImGui::CollapsingHeader("Media", ImGuiTreeNodeFlags_DefaultOpen))
   {
-    if (m_media)
+    if (HasMedia())
     {
-      const auto [disc_minute, disc_second, disc_frame] = m_media->GetMSFPositionOnDisc();
-      const auto [track_minute, track_second, track_frame] = m_media->GetMSFPositionInTrack();
-
-      ImGui::Text("Filename: %s", m_media->GetFileName().c_str());
-      ImGui::Text("Disc Position: MSF[%02u:%02u:%02u] LBA[%u]", disc_minute, disc_second, disc_frame,
-                  m_media->GetPositionOnDisc());
-      ImGui::Text("Track Position: Number[%u] MSF[%02u:%02u:%02u] LBA[%u]", m_media->GetTrackNumber(), track_minute,
-                  track_second, track_frame, m_media->GetPositionInTrack());
+      const CDImage* media = m_reader.GetMedia();
+      const auto [disc_minute, disc_second, disc_frame] = CDImage::Position::FromLBA(m_current_lba);
+      const u32 track_number = GetCurrentTrackNumber();
+      const CDImage::LBA track_lba = m_current_lba - std::min(m_current_lba, media->GetTrackStartPosition(track_number));
+      const auto [track_minute, track_second, track_frame] = CDImage::Position::FromLBA(track_lba);
+
+      ImGui::Text("Filename: %s", media->GetFileName().c_str());
+      ImGui::Text("Disc Position: MSF[%02u:%02u:%02u] LBA[%u]", disc_minute, disc_second, disc_frame, m_current_lba);
+      ImGui::Text("Track Position: Number[%u] MSF[%02u:%02u:%02u] LBA[%u]", track_number, track_minute, track_second,
+                  track_frame, track_lba);
+      ImGui::Text("Read-Ahead: %u sectors buffered, %u hits, %u misses", m_reader.GetBufferedSectorCount(),
+                  m_reader.GetReadHitCount(), m_reader.GetReadMissCount());
+
+      u32 cache_hits, cache_misses;
+      if (media->GetCacheStatistics(&cache_hits, &cache_misses))
+        ImGui::Text("Decompression Cache: %u hits, %u misses", cache_hits, cache_misses);
       ImGui::Text("Last Sector: %02X:%02X:%02X (Mode %u)", m_last_sector_header.minute, m_last_sector_header.second,
                   m_last_sector_header.frame, m_last_sector_header.sector_mode);
     }
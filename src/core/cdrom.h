@@ -1,4 +1,5 @@
 #pragma once
+#include "cdrom_async_reader.h"
 #include "common/bitfield.h"
 #include "common/cd_image.h"
 #include "common/cd_xa.h"
@@ -27,11 +28,14 @@ public:
   void Reset();
   bool DoState(StateWrapper& sw);
 
-  bool HasMedia() const { return static_cast<bool>(m_media); }
+  bool HasMedia() const { return m_reader.HasMedia(); }
   std::string GetMediaFileName() const;
   void InsertMedia(std::unique_ptr<CDImage> media);
   void RemoveMedia();
 
+  // Reschedules an in-progress read after the read speedup setting changes.
+  void UpdateReadSpeed();
+
   // I/O
   u8 ReadRegister(u32 offset);
   void WriteRegister(u32 offset, u8 value);
@@ -59,6 +63,11 @@ private:
 
   static constexpr u8 INTERRUPT_REGISTER_MASK = 0x1F;
 
+  static constexpr TickCount MIN_SEEK_TICKS = 20000;
+
+  // Sector interval with the speedup set to maximum. Reads are then paced by the CPU acknowledging each sector.
+  static constexpr TickCount MIN_SPEEDUP_READ_TICKS = 2000;
+
   enum class Interrupt : u8
   {
     INT1 = 0x01,
@@ -190,7 +199,9 @@ private:
   void UpdateStatusRegister();
   void UpdateInterruptRequest();
 
+  u8 GetCurrentTrackNumber() const;
   TickCount GetAckDelayForCommand() const;
+  bool IsReadSpeedupActive() const;
   TickCount GetTicksForRead() const;
   TickCount GetTicksForSeek() const;
   void BeginCommand(Command command); // also update status register
@@ -219,7 +230,7 @@ private:
   DMA* m_dma = nullptr;
   InterruptController* m_interrupt_controller = nullptr;
   SPU* m_spu = nullptr;
-  std::unique_ptr<CDImage> m_media;
+  CDROMAsyncReader m_reader;
   std::unique_ptr<TimingEvent> m_command_event;
   std::unique_ptr<TimingEvent> m_drive_event;
 
@@ -234,6 +245,9 @@ private:
   u8 m_interrupt_flag_register = 0;
   u8 m_pending_async_interrupt = 0;
 
+  // Next sector the drive will read.
+  CDImage::LBA m_current_lba = 0;
+
   CDImage::Position m_setloc_position = {};
   CDImage::Position m_seek_position = {};
   bool m_setloc_pending = false;
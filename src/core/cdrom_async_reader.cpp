@@ -0,0 +1,178 @@
+#include "cdrom_async_reader.h"
+#include "common/assert.h"
+#include "common/log.h"
+Log_SetChannel(CDROMAsyncReader);
+
+// Marks buffer slots which don't hold a sector, or are being written by the worker.
+static constexpr CDImage::LBA INVALID_LBA = UINT32_C(0xFFFFFFFF);
+
+CDROMAsyncReader::CDROMAsyncReader() = default;
+
+CDROMAsyncReader::~CDROMAsyncReader()
+{
+  StopThread();
+}
+
+void CDROMAsyncReader::SetMedia(std::unique_ptr<CDImage> media)
+{
+  StopThread();
+
+  m_media = std::move(media);
+  if (!m_media)
+    return;
+
+  m_buffer_start_lba = m_media->GetPositionOnDisc();
+  StartThread();
+}
+
+void CDROMAsyncReader::RemoveMedia()
+{
+  StopThread();
+  m_media.reset();
+}
+
+void CDROMAsyncReader::StartThread()
+{
+  DebugAssert(!m_thread.joinable());
+  m_shutdown = false;
+  m_buffered_count.store(0);
+  for (BufferedSector& bs : m_buffer)
+    bs.lba = INVALID_LBA;
+  m_thread = std::thread(&CDROMAsyncReader::WorkerThreadEntryPoint, this);
+}
+
+void CDROMAsyncReader::StopThread()
+{
+  if (!m_thread.joinable())
+    return;
+
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_shutdown = true;
+    m_worker_cv.notify_one();
+  }
+
+  m_thread.join();
+  m_buffered_count.store(0);
+  m_generation++;
+}
+
+void CDROMAsyncReader::Retarget(CDImage::LBA lba)
+{
+  m_buffer_start_lba = lba;
+  m_buffered_count.store(0);
+  m_generation++;
+  m_worker_cv.notify_one();
+}
+
+bool CDROMAsyncReader::MoveTo(CDImage::LBA lba)
+{
+  const u32 buffered_count = m_buffered_count.load();
+  if (lba >= m_buffer_start_lba && (lba - m_buffer_start_lba) <= buffered_count)
+  {
+    // keep whatever we've already read after the new position, anything before it goes to the history
+    if (lba != m_buffer_start_lba)
+    {
+      m_buffered_count.store(buffered_count - (lba - m_buffer_start_lba));
+      m_buffer_start_lba = lba;
+      m_worker_cv.notify_one();
+    }
+
+    return true;
+  }
+
+  if (MoveBackInHistory(lba))
+    return true;
+
+  Retarget(lba);
+  return false;
+}
+
+bool CDROMAsyncReader::MoveBackInHistory(CDImage::LBA lba)
+{
+  // the buffered sectors can't wrap around the ring
+  const u32 new_buffered_count = (m_buffer_start_lba - lba) + m_buffered_count.load();
+  if (lba >= m_buffer_start_lba || new_buffered_count >= BUFFER_SIZE)
+    return false;
+
+  for (CDImage::LBA current_lba = lba; current_lba != m_buffer_start_lba; current_lba++)
+  {
+    if (m_buffer[current_lba % BUFFER_SIZE].lba != current_lba)
+      return false;
+  }
+
+  // the worker carries on from the same position, so anything in flight is still wanted
+  m_buffer_start_lba = lba;
+  m_buffered_count.store(new_buffered_count);
+  return true;
+}
+
+void CDROMAsyncReader::QueueReadSector(CDImage::LBA lba)
+{
+  if (!m_media)
+    return;
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  if (!MoveTo(lba))
+    Log_DevPrintf("Read-ahead retargeted to LBA %u", lba);
+}
+
+const u8* CDROMAsyncReader::ReadSector(CDImage::LBA lba, CDImage::SubChannelQ* subq)
+{
+  if (!m_media)
+    return nullptr;
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  if (!MoveTo(lba))
+    Log_DevPrintf("Read-ahead missed LBA %u, retargeting", lba);
+
+  if (m_buffered_count.load() == 0)
+  {
+    m_miss_count++;
+    m_done_cv.wait(lock, [this]() { return m_buffered_count.load() > 0; });
+  }
+  else
+  {
+    m_hit_count++;
+  }
+
+  // the worker never writes to the first buffered sector, so the pointer remains valid after unlocking
+  const BufferedSector& bs = m_buffer[lba % BUFFER_SIZE];
+  DebugAssert(bs.lba == lba);
+  if (!bs.result)
+    return nullptr;
+
+  *subq = bs.subq;
+  return bs.data.data();
+}
+
+void CDROMAsyncReader::WorkerThreadEntryPoint()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  for (;;)
+  {
+    m_worker_cv.wait(lock, [this]() { return m_shutdown || m_buffered_count.load() < READAHEAD_SECTORS; });
+    if (m_shutdown)
+      break;
+
+    const CDImage::LBA lba = m_buffer_start_lba + m_buffered_count.load();
+    const u32 generation = m_generation;
+    BufferedSector& bs = m_buffer[lba % BUFFER_SIZE];
+    bs.lba = INVALID_LBA;
+    lock.unlock();
+
+    const bool result =
+      m_media->Seek(lba) && m_media->ReadSubChannelQ(&bs.subq) && m_media->ReadRawSector(bs.data.data());
+
+    lock.lock();
+
+    // discard the sector if we were retargeted while reading it
+    if (generation != m_generation)
+      continue;
+
+    bs.lba = lba;
+    bs.result = result;
+    m_buffered_count.fetch_add(1);
+    m_done_cv.notify_one();
+  }
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include "common/cd_image.h"
+#include "types.h"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/// Reads sectors from the disc image on a worker thread, staying a number of sectors ahead of the emulated drive.
+/// While the thread is running, the image must only be accessed through this class, apart from the metadata accessors
+/// which do not depend on the image's current position (track count/starts, file name, etc).
+class CDROMAsyncReader
+{
+public:
+  enum : u32
+  {
+    READAHEAD_SECTORS = 32,
+
+    // Sectors which have already been read are kept for a while, so that the position can move back a little without
+    // throwing away the read-ahead. Run-ahead does this every frame, and can read up to ~100 sectors ahead with the
+    // maximum read speedup.
+    HISTORY_SECTORS = 128,
+
+    BUFFER_SIZE = READAHEAD_SECTORS + HISTORY_SECTORS
+  };
+
+  CDROMAsyncReader();
+  ~CDROMAsyncReader();
+
+  bool HasMedia() const { return static_cast<bool>(m_media); }
+  const CDImage* GetMedia() const { return m_media.get(); }
+  const std::string& GetMediaFileName() const { return m_media->GetFileName(); }
+
+  void SetMedia(std::unique_ptr<CDImage> media);
+  void RemoveMedia();
+
+  /// Moves the read-ahead position to the specified LBA. Sectors which are already buffered past this point are kept,
+  /// as are recently-read sectors before the current position.
+  void QueueReadSector(CDImage::LBA lba);
+
+  /// Returns the raw sector at the specified LBA, blocking if it has not been read yet. Sectors before lba are
+  /// released to the history, the returned pointer is valid until the next call to ReadSector() or QueueReadSector().
+  /// Returns nullptr if the sector could not be read.
+  const u8* ReadSector(CDImage::LBA lba, CDImage::SubChannelQ* subq);
+
+  /// Statistics for the debug window.
+  u32 GetBufferedSectorCount() const { return m_buffered_count; }
+  u32 GetReadHitCount() const { return m_hit_count; }
+  u32 GetReadMissCount() const { return m_miss_count; }
+
+private:
+  struct BufferedSector
+  {
+    CDImage::LBA lba;
+    bool result;
+    CDImage::SubChannelQ subq;
+    std::array<u8, CDImage::RAW_SECTOR_SIZE> data;
+  };
+
+  void StartThread();
+  void StopThread();
+  void WorkerThreadEntryPoint();
+
+  /// Moves the position to lba, keeping the buffered sectors after it if there are any. Otherwise, discards them and
+  /// restarts reading from lba, returning false. Assumes m_mutex is held.
+  bool MoveTo(CDImage::LBA lba);
+
+  /// Moves the start of the buffer back to lba, if the sectors in between are still in the history. Assumes m_mutex
+  /// is held.
+  bool MoveBackInHistory(CDImage::LBA lba);
+
+  /// Discards all buffered sectors and restarts reading from lba. Assumes m_mutex is held.
+  void Retarget(CDImage::LBA lba);
+
+  std::unique_ptr<CDImage> m_media;
+
+  std::thread m_thread;
+  std::mutex m_mutex;
+  std::condition_variable m_worker_cv;
+  std::condition_variable m_done_cv;
+
+  // Sectors [m_buffer_start_lba, m_buffer_start_lba + m_buffered_count) are in m_buffer, at index lba % size. Slots
+  // before that hold history, and are valid while their lba matches. The worker invalidates a slot while writing it.
+  std::array<BufferedSector, BUFFER_SIZE> m_buffer;
+  CDImage::LBA m_buffer_start_lba = 0;
+  std::atomic<u32> m_buffered_count{0};
+
+  // Bumped on every retarget, so that reads which were in flight at the time are discarded.
+  u32 m_generation = 0;
+  bool m_shutdown = false;
+
+  std::atomic<u32> m_hit_count{0};
+  std::atomic<u32> m_miss_count{0};
+};
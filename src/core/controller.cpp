@@ -36,6 +36,8 @@ float Controller::GetVibrationMotorStrength(u32 motor)
   return 0.0f;
 }
 
+void Controller::SetRunningAhead(bool running_ahead) {}
+
 std::unique_ptr<Controller> Controller::Create(ControllerType type)
 {
   switch (type)
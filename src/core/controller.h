@@ -47,6 +47,9 @@ public:
   /// Queries the state of the specified vibration motor. Values are normalized from 0..1.
   virtual float GetVibrationMotorStrength(u32 motor);
 
+  /// While running ahead, the vibration motor strengths stay at their values from before.
+  virtual void SetRunningAhead(bool running_ahead);
+
   /// Creates a new controller of the specified type.
   static std::unique_ptr<Controller> Create(ControllerType type);
 
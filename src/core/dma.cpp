@@ -448,6 +448,11 @@ void DMA::TransferDeviceToMemory(Channel channel, u32 address, u32 increment, u3
   if (m_transfer_buffer.size() < word_count)
     m_transfer_buffer.resize(word_count);
 
+  // When the destination is contiguous, devices can write straight into RAM instead of going through the buffer.
+  const bool contiguous = (increment > 0 && ((address + (increment * word_count)) & ADDRESS_MASK) > address);
+  u32* ram_words = (contiguous && channel != Channel::OTC) ? m_bus->GetRAMWordsForWrite(address, word_count) : nullptr;
+  u32* dest_words = ram_words ? ram_words : m_transfer_buffer.data();
+
   // Read from device.
   switch (channel)
   {
@@ -484,30 +489,33 @@ void DMA::TransferDeviceToMemory(Channel channel, u32 address, u32 increment, u3
     break;
 
     case Channel::GPU:
-      m_gpu->DMARead(m_transfer_buffer.data(), word_count);
+      m_gpu->DMARead(dest_words, word_count);
       break;
 
     case Channel::CDROM:
-      m_cdrom->DMARead(m_transfer_buffer.data(), word_count);
+      m_cdrom->DMARead(dest_words, word_count);
       break;
 
     case Channel::SPU:
-      m_spu->DMARead(m_transfer_buffer.data(), word_count);
+      m_spu->DMARead(dest_words, word_count);
       break;
 
     case Channel::MDECout:
-      m_mdec->DMARead(m_transfer_buffer.data(), word_count);
+      m_mdec->DMARead(dest_words, word_count);
       break;
 
     case Channel::MDECin:
     case Channel::PIO:
     default:
       Panic("Unhandled DMA channel for device read");
-      std::fill_n(m_transfer_buffer.begin(), word_count, UINT32_C(0xFFFFFFFF));
+      std::fill_n(dest_words, word_count, UINT32_C(0xFFFFFFFF));
       break;
   }
 
-  if (increment > 0 && ((address + (increment * word_count)) & ADDRESS_MASK) > address)
+  if (ram_words)
+    return;
+
+  if (contiguous)
   {
     m_bus->WriteWords(address, m_transfer_buffer.data(), word_count);
   }
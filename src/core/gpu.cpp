@@ -70,7 +70,7 @@ void GPU::SoftReset()
   UpdateSliceTicks();
 }
 
-bool GPU::DoState(StateWrapper& sw)
+bool GPU::DoState(StateWrapper& sw, bool vram_backup, std::vector<u16>* vram_copy)
 {
   if (sw.IsReading())
   {
@@ -146,6 +146,9 @@ bool GPU::DoState(StateWrapper& sw)
   if (!sw.DoMarker("GPU-VRAM"))
     return false;
 
+  if (vram_copy && sw.IsReading() && vram_copy->size() != (VRAM_WIDTH * VRAM_HEIGHT))
+    return false;
+
   if (sw.IsReading())
   {
     // Need to clear the mask bits since we want to pull it in from the copy.
@@ -153,10 +156,21 @@ bool GPU::DoState(StateWrapper& sw)
     m_GPUSTAT.check_mask_before_draw = false;
     m_GPUSTAT.set_mask_while_drawing = false;
 
-    // Still need a temporary here.
-    HeapArray<u16, VRAM_WIDTH * VRAM_HEIGHT> temp;
-    sw.DoBytes(temp.data(), VRAM_WIDTH * VRAM_HEIGHT * sizeof(u16));
-    UpdateVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT, temp.data());
+    if (vram_backup)
+    {
+      RestoreVRAMBackup();
+    }
+    else if (vram_copy)
+    {
+      UpdateVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT, vram_copy->data());
+    }
+    else
+    {
+      // Still need a temporary here.
+      HeapArray<u16, VRAM_WIDTH * VRAM_HEIGHT> temp;
+      sw.DoBytes(temp.data(), VRAM_WIDTH * VRAM_HEIGHT * sizeof(u16));
+      UpdateVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT, temp.data());
+    }
 
     // Restore mask setting.
     m_GPUSTAT.bits = old_GPUSTAT;
@@ -164,6 +178,16 @@ bool GPU::DoState(StateWrapper& sw)
     UpdateDisplay();
     UpdateSliceTicks();
   }
+  else if (vram_backup)
+  {
+    if (!SaveVRAMBackup())
+      return false;
+  }
+  else if (vram_copy)
+  {
+    ReadVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
+    vram_copy->assign(m_vram_ptr, m_vram_ptr + (VRAM_WIDTH * VRAM_HEIGHT));
+  }
   else
   {
     ReadVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
@@ -966,3 +990,16 @@ void GPU::DrawDebugStateWindow()
 }
 
 void GPU::DrawRendererStats(bool is_idle_frame) {}
+
+bool GPU::SaveVRAMBackup()
+{
+  ReadVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
+  m_vram_backup.assign(m_vram_ptr, m_vram_ptr + (VRAM_WIDTH * VRAM_HEIGHT));
+  return true;
+}
+
+void GPU::RestoreVRAMBackup()
+{
+  if (!m_vram_backup.empty())
+    UpdateVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT, m_vram_backup.data());
+}
@@ -111,7 +111,11 @@ public:
   virtual bool Initialize(HostDisplay* host_display, System* system, DMA* dma,
                           InterruptController* interrupt_controller, Timers* timers);
   virtual void Reset();
-  virtual bool DoState(StateWrapper& sw);
+
+  // If vram_backup is set, VRAM is kept in a backup held by the renderer instead of being serialized. Only valid for
+  // short-lived in-memory states, but saves a readback and preserves the upscaled VRAM in the hardware renderers.
+  // Otherwise, if vram_copy is set, VRAM is transferred to/from it instead of the stream.
+  virtual bool DoState(StateWrapper& sw, bool vram_backup, std::vector<u16>* vram_copy);
 
   // Graphics API state reset/restore - call when drawing the UI etc.
   virtual void ResetGraphicsAPIState();
@@ -331,6 +335,8 @@ protected:
   virtual void FlushRender();
   virtual void UpdateDisplay();
   virtual void DrawRendererStats(bool is_idle_frame);
+  virtual bool SaveVRAMBackup();
+  virtual void RestoreVRAMBackup();
 
   HostDisplay* m_host_display = nullptr;
   System* m_system = nullptr;
@@ -343,6 +349,9 @@ protected:
   // Pointer to VRAM, used for reads/writes. In the hardware backends, this is the shadow buffer.
   u16* m_vram_ptr = nullptr;
 
+  // Copy of VRAM for in-memory states, unless the backend keeps its own.
+  std::vector<u16> m_vram_backup;
+
   union GPUSTAT
   {
     u32 bits;
@@ -46,9 +46,9 @@ void GPU_HW::Reset()
   SetFullVRAMDirtyRectangle();
 }
 
-bool GPU_HW::DoState(StateWrapper& sw)
+bool GPU_HW::DoState(StateWrapper& sw, bool vram_backup, std::vector<u16>* vram_copy)
 {
-  if (!GPU::DoState(sw))
+  if (!GPU::DoState(sw, vram_backup, vram_copy))
     return false;
 
   // invalidate the whole VRAM read texture when loading state
@@ -223,7 +223,7 @@ void GPU_HW::LoadVertices(RenderCommand rc, u32 num_vertices, const u32* command
     std::clamp(m_drawing_offset.y + max_y, static_cast<s32>(m_drawing_area.top),
                static_cast<s32>(m_drawing_area.bottom)) +
       1);
-  m_vram_dirty_rect.Include(area_covered);
+  IncludeVRAMDrawnArea(area_covered);
 }
 
 void GPU_HW::AddDuplicateVertex()
@@ -266,9 +266,58 @@ GPU_HW::BatchPrimitive GPU_HW::GetPrimitiveForCommand(RenderCommand rc)
     return BatchPrimitive::Triangles;
 }
 
+u32 GPU_HW::GetVRAMTileMask(const Common::Rectangle<u32>& rect)
+{
+  if (!rect.HasExtents())
+    return 0;
+
+  const u32 first_tile_x = rect.left / VRAM_TILE_WIDTH;
+  const u32 num_tiles_x = std::min((rect.right - 1) / VRAM_TILE_WIDTH - first_tile_x + 1, u32(VRAM_TILES_X));
+  const u32 first_tile_y = std::min(rect.top / VRAM_TILE_HEIGHT, u32(VRAM_TILES_Y - 1));
+  const u32 last_tile_y = std::min((rect.bottom - 1) / VRAM_TILE_HEIGHT, u32(VRAM_TILES_Y - 1));
+
+  u32 row_mask = 0;
+  for (u32 i = 0; i < num_tiles_x; i++)
+    row_mask |= 1u << ((first_tile_x + i) % VRAM_TILES_X);
+
+  u32 mask = 0;
+  for (u32 tile_y = first_tile_y; tile_y <= last_tile_y; tile_y++)
+    mask |= row_mask << (tile_y * VRAM_TILES_X);
+
+  return mask;
+}
+
+void GPU_HW::UpdateVRAMReadTextureTiles(u32 tiles)
+{
+  // copy each horizontal run of tiles in one go, rather than the bounding box of everything
+  for (u32 tile_y = 0; tile_y < VRAM_TILES_Y; tile_y++)
+  {
+    const u32 row_tiles = (tiles >> (tile_y * VRAM_TILES_X)) & ((1u << VRAM_TILES_X) - 1);
+    u32 tile_x = 0;
+    while (tile_x < VRAM_TILES_X)
+    {
+      if (!(row_tiles & (1u << tile_x)))
+      {
+        tile_x++;
+        continue;
+      }
+
+      const u32 run_start = tile_x;
+      while (tile_x < VRAM_TILES_X && (row_tiles & (1u << tile_x)))
+        tile_x++;
+
+      UpdateVRAMReadTexture(Common::Rectangle<u32>(run_start * VRAM_TILE_WIDTH, tile_y * VRAM_TILE_HEIGHT,
+                                                   tile_x * VRAM_TILE_WIDTH, (tile_y + 1) * VRAM_TILE_HEIGHT));
+      m_renderer_stats.num_vram_read_texture_tiles += tile_x - run_start;
+    }
+  }
+
+  m_vram_dirty_tiles &= ~tiles;
+}
+
 void GPU_HW::IncludeVRAMDityRectangle(const Common::Rectangle<u32>& rect)
 {
-  m_vram_dirty_rect.Include(rect);
+  m_vram_dirty_tiles |= GetVRAMTileMask(rect);
 
   // the vram area can include the texture page, but the game can leave it as-is. in this case, set it as dirty so the
   // shadow texture is updated
@@ -302,20 +351,24 @@ void GPU_HW::DispatchRenderCommand(RenderCommand rc, u32 num_vertices, const u32
   TextureMode texture_mode;
   if (rc.IsTexturingEnabled())
   {
-    // texture page changed - check that the new page doesn't intersect the drawing area
+    // texture page changed - check that the new page doesn't sample any tiles which have been drawn to
     if (m_draw_mode.IsTexturePageChanged())
     {
       m_draw_mode.ClearTexturePageChangedFlag();
-      if (m_vram_dirty_rect.Valid() && (m_draw_mode.GetTexturePageRectangle().Intersects(m_vram_dirty_rect) ||
-                                        m_draw_mode.GetTexturePaletteRectangle().Intersects(m_vram_dirty_rect)))
+      m_texture_page_vram_tiles = GetVRAMTileMask(m_draw_mode.GetTexturePageRectangle()) |
+                                  GetVRAMTileMask(m_draw_mode.GetTexturePaletteRectangle());
+
+      const u32 stale_tiles = m_texture_page_vram_tiles & m_vram_dirty_tiles;
+      if (stale_tiles != 0)
       {
-        Log_DevPrintf("Invalidating VRAM read cache due to drawing area overlap");
-        if (!IsFlushed())
+        Log_DevPrintf("Invalidating VRAM read cache tiles 0x%08X due to drawing area overlap", stale_tiles);
+
+        // the pending batch only has to be drawn first if it samples or draws to the tiles being replaced
+        if (!IsFlushed() && (m_batch_vram_tiles & stale_tiles) != 0)
           FlushRender();
 
-        UpdateVRAMReadTexture();
+        UpdateVRAMReadTextureTiles(stale_tiles);
         m_renderer_stats.num_vram_read_texture_updates++;
-        ClearVRAMDirtyRectangle();
       }
     }
 
@@ -379,6 +432,12 @@ void GPU_HW::DispatchRenderCommand(RenderCommand rc, u32 num_vertices, const u32
   if (!m_batch_current_vertex_ptr)
     MapBatchVertexPointer(max_added_vertices);
 
+  // track the tiles this batch reads from, so we know whether it has to be flushed before they're updated
+  if (IsFlushed())
+    m_batch_vram_tiles = 0;
+  if (texture_mode != TextureMode::Disabled)
+    m_batch_vram_tiles |= m_texture_page_vram_tiles;
+
   // update state
   m_batch.primitive = rc_primitive;
   m_batch.texture_mode = texture_mode;
@@ -424,6 +483,11 @@ void GPU_HW::DrawRendererStats(bool is_idle_frame)
     ImGui::Text("%u", stats.num_vram_read_texture_updates);
     ImGui::NextColumn();
 
+    ImGui::TextUnformatted("VRAM Read Texture Tiles:");
+    ImGui::NextColumn();
+    ImGui::Text("%u", stats.num_vram_read_texture_tiles);
+    ImGui::NextColumn();
+
     ImGui::TextUnformatted("Uniform Buffer Updates: ");
     ImGui::NextColumn();
     ImGui::Text("%u", stats.num_uniform_buffer_updates);
@@ -34,7 +34,7 @@ public:
   virtual bool Initialize(HostDisplay* host_display, System* system, DMA* dma,
                           InterruptController* interrupt_controller, Timers* timers) override;
   virtual void Reset() override;
-  virtual bool DoState(StateWrapper& sw) override;
+  virtual bool DoState(StateWrapper& sw, bool vram_backup, std::vector<u16>* vram_copy) override;
   virtual void UpdateSettings() override;
 
 protected:
@@ -45,6 +45,17 @@ protected:
     UNIFORM_BUFFER_SIZE = 512 * 1024
   };
 
+  // VRAM is split into texture page-sized tiles for tracking which parts of the read texture are out of date.
+  enum : u32
+  {
+    VRAM_TILE_WIDTH = 64,
+    VRAM_TILE_HEIGHT = 256,
+    VRAM_TILES_X = VRAM_WIDTH / VRAM_TILE_WIDTH,
+    VRAM_TILES_Y = VRAM_HEIGHT / VRAM_TILE_HEIGHT,
+    VRAM_ALL_TILES_MASK = 0xFFFFFFFFu
+  };
+  static_assert((VRAM_TILES_X * VRAM_TILES_Y) == 32, "VRAM tiles fit in a 32-bit mask");
+
   struct BatchVertex
   {
     s32 x;
@@ -108,6 +119,7 @@ protected:
   {
     u32 num_batches;
     u32 num_vram_read_texture_updates;
+    u32 num_vram_read_texture_tiles;
     u32 num_uniform_buffer_updates;
   };
 
@@ -120,16 +132,29 @@ protected:
   }
 
   virtual void MapBatchVertexPointer(u32 required_vertices) = 0;
-  virtual void UpdateVRAMReadTexture() = 0;
+  virtual void UpdateVRAMReadTexture(const Common::Rectangle<u32>& rect) = 0;
+
+  /// Returns a mask of the VRAM tiles which the specified rectangle touches. X wraps around, as with texture pages.
+  static u32 GetVRAMTileMask(const Common::Rectangle<u32>& rect);
 
   void SetFullVRAMDirtyRectangle()
   {
-    m_vram_dirty_rect.Set(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
+    m_vram_dirty_tiles = VRAM_ALL_TILES_MASK;
     m_draw_mode.SetTexturePageChanged();
   }
-  void ClearVRAMDirtyRectangle() { m_vram_dirty_rect.SetInvalid(); }
   void IncludeVRAMDityRectangle(const Common::Rectangle<u32>& rect);
 
+  /// Marks the area as drawn to by the current batch, without forcing a texture page re-check.
+  void IncludeVRAMDrawnArea(const Common::Rectangle<u32>& rect)
+  {
+    const u32 mask = GetVRAMTileMask(rect);
+    m_vram_dirty_tiles |= mask;
+    m_batch_vram_tiles |= mask;
+  }
+
+  /// Copies the specified dirty tiles from the VRAM texture to the read texture.
+  void UpdateVRAMReadTextureTiles(u32 tiles);
+
   u32 GetBatchVertexSpace() const { return static_cast<u32>(m_batch_end_vertex_ptr - m_batch_current_vertex_ptr); }
   u32 GetBatchVertexCount() const { return static_cast<u32>(m_batch_current_vertex_ptr - m_batch_start_vertex_ptr); }
 
@@ -168,8 +193,14 @@ protected:
   BatchConfig m_batch = {};
   BatchUBOData m_batch_ubo_data = {};
 
-  // Bounding box of VRAM area that the GPU has drawn into.
-  Common::Rectangle<u32> m_vram_dirty_rect;
+  // Mask of VRAM tiles that the GPU has drawn into since they were last copied to the read texture.
+  u32 m_vram_dirty_tiles = 0;
+
+  // Mask of VRAM tiles which are sampled or drawn into by the batch which has not been flushed yet.
+  u32 m_batch_vram_tiles = 0;
+
+  // Mask of VRAM tiles covered by the current texture page and palette.
+  u32 m_texture_page_vram_tiles = 0;
 
   // Statistics
   RendererStats m_renderer_stats = {};
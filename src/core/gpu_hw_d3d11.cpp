@@ -493,7 +493,6 @@ void GPU_HW_D3D11::SetDrawState(BatchRenderMode render_mode)
   if (m_drawing_area_changed)
   {
     m_drawing_area_changed = false;
-    m_vram_dirty_rect.Include(m_drawing_area);
     SetScissorFromDrawingArea();
   }
 
@@ -707,14 +706,55 @@ void GPU_HW_D3D11::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 widt
   m_context->CopySubresourceRegion(m_vram_texture, 0, dst_x, dst_y, 0, m_vram_texture, 0, &src_box);
 }
 
-void GPU_HW_D3D11::UpdateVRAMReadTexture()
+void GPU_HW_D3D11::UpdateVRAMReadTexture(const Common::Rectangle<u32>& rect)
 {
-  const auto scaled_rect = m_vram_dirty_rect * m_resolution_scale;
+  const auto scaled_rect = rect * m_resolution_scale;
   const CD3D11_BOX src_box(scaled_rect.left, scaled_rect.top, 0, scaled_rect.right, scaled_rect.bottom, 1);
   m_context->CopySubresourceRegion(m_vram_read_texture, 0, scaled_rect.left, scaled_rect.top, 0, m_vram_texture, 0,
                                    &src_box);
 }
 
+bool GPU_HW_D3D11::SaveVRAMBackup()
+{
+  FlushRender();
+
+  if (m_vram_backup_texture.GetWidth() != m_vram_texture.GetWidth() ||
+      m_vram_backup_texture.GetHeight() != m_vram_texture.GetHeight())
+  {
+    m_vram_backup_texture.Destroy();
+    if (!m_vram_backup_texture.Create(m_device.Get(), m_vram_texture.GetWidth(), m_vram_texture.GetHeight(),
+                                      m_vram_texture.GetFormat(), true, false))
+    {
+      Log_ErrorPrintf("Failed to create VRAM backup texture");
+      return false;
+    }
+  }
+
+  m_context->CopyResource(m_vram_backup_texture, m_vram_texture);
+  return true;
+}
+
+void GPU_HW_D3D11::RestoreVRAMBackup()
+{
+  if (!m_vram_backup_texture)
+    return;
+
+  if (m_vram_backup_texture.GetWidth() == m_vram_texture.GetWidth() &&
+      m_vram_backup_texture.GetHeight() == m_vram_texture.GetHeight())
+  {
+    m_context->CopyResource(m_vram_texture, m_vram_backup_texture);
+    return;
+  }
+
+  // The resolution scale has changed since the backup was made.
+  const bool linear_filter = m_vram_backup_texture.GetWidth() > m_vram_texture.GetWidth();
+  BlitTexture(m_vram_texture.GetD3DRTV(), 0, 0, m_vram_texture.GetWidth(), m_vram_texture.GetHeight(),
+              m_vram_backup_texture.GetD3DSRV(), 0, 0, m_vram_backup_texture.GetWidth(),
+              m_vram_backup_texture.GetHeight(), m_vram_backup_texture.GetWidth(), m_vram_backup_texture.GetHeight(),
+              linear_filter);
+  RestoreGraphicsAPIState();
+}
+
 void GPU_HW_D3D11::FlushRender()
 {
   const u32 vertex_count = GetBatchVertexCount();
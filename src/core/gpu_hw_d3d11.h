@@ -35,7 +35,9 @@ protected:
   void CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height) override;
   void FlushRender() override;
   void MapBatchVertexPointer(u32 required_vertices) override;
-  void UpdateVRAMReadTexture() override;
+  void UpdateVRAMReadTexture(const Common::Rectangle<u32>& rect) override;
+  bool SaveVRAMBackup() override;
+  void RestoreVRAMBackup() override;
 
 private:
   void SetCapabilities();
@@ -74,6 +76,7 @@ private:
   D3D11::Texture m_vram_read_texture;
   D3D11::Texture m_vram_encoding_texture;
   D3D11::Texture m_display_texture;
+  D3D11::Texture m_vram_backup_texture;
 
   D3D11::StreamBuffer m_vertex_stream_buffer;
 
@@ -435,7 +435,6 @@ void GPU_HW_OpenGL::SetDrawState(BatchRenderMode render_mode)
   if (m_drawing_area_changed)
   {
     m_drawing_area_changed = false;
-    m_vram_dirty_rect.Include(m_drawing_area);
     SetScissorFromDrawingArea();
   }
 
@@ -785,9 +784,9 @@ void GPU_HW_OpenGL::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 wid
   }
 }
 
-void GPU_HW_OpenGL::UpdateVRAMReadTexture()
+void GPU_HW_OpenGL::UpdateVRAMReadTexture(const Common::Rectangle<u32>& rect)
 {
-  const auto scaled_rect = m_vram_dirty_rect * m_resolution_scale;
+  const auto scaled_rect = rect * m_resolution_scale;
   const u32 width = scaled_rect.GetWidth();
   const u32 height = scaled_rect.GetHeight();
   const u32 x = scaled_rect.left;
@@ -814,6 +813,50 @@ void GPU_HW_OpenGL::UpdateVRAMReadTexture()
   }
 }
 
+bool GPU_HW_OpenGL::SaveVRAMBackup()
+{
+  FlushRender();
+
+  if (m_vram_backup_texture.GetWidth() != m_vram_texture.GetWidth() ||
+      m_vram_backup_texture.GetHeight() != m_vram_texture.GetHeight())
+  {
+    if (!m_vram_backup_texture.Create(m_vram_texture.GetWidth(), m_vram_texture.GetHeight(), GL_RGBA,
+                                      GL_UNSIGNED_BYTE, nullptr, false) ||
+        !m_vram_backup_texture.CreateFramebuffer())
+    {
+      Log_ErrorPrintf("Failed to create VRAM backup texture");
+      m_vram_backup_texture.Destroy();
+      return false;
+    }
+  }
+
+  m_vram_backup_texture.BindFramebuffer(GL_DRAW_FRAMEBUFFER);
+  m_vram_texture.BindFramebuffer(GL_READ_FRAMEBUFFER);
+  glDisable(GL_SCISSOR_TEST);
+  glBlitFramebuffer(0, 0, m_vram_texture.GetWidth(), m_vram_texture.GetHeight(), 0, 0, m_vram_texture.GetWidth(),
+                    m_vram_texture.GetHeight(), GL_COLOR_BUFFER_BIT, GL_NEAREST);
+  glEnable(GL_SCISSOR_TEST);
+  m_vram_texture.BindFramebuffer(GL_FRAMEBUFFER);
+  return true;
+}
+
+void GPU_HW_OpenGL::RestoreVRAMBackup()
+{
+  if (!m_vram_backup_texture.IsValid())
+    return;
+
+  // The resolution scale could have changed since the backup was made.
+  const bool linear_filter = m_vram_backup_texture.GetWidth() > m_vram_texture.GetWidth();
+  m_vram_texture.BindFramebuffer(GL_DRAW_FRAMEBUFFER);
+  m_vram_backup_texture.BindFramebuffer(GL_READ_FRAMEBUFFER);
+  glDisable(GL_SCISSOR_TEST);
+  glBlitFramebuffer(0, 0, m_vram_backup_texture.GetWidth(), m_vram_backup_texture.GetHeight(), 0, 0,
+                    m_vram_texture.GetWidth(), m_vram_texture.GetHeight(), GL_COLOR_BUFFER_BIT,
+                    linear_filter ? GL_LINEAR : GL_NEAREST);
+  glEnable(GL_SCISSOR_TEST);
+  m_vram_texture.BindFramebuffer(GL_FRAMEBUFFER);
+}
+
 void GPU_HW_OpenGL::FlushRender()
 {
   const u32 vertex_count = GetBatchVertexCount();
@@ -29,7 +29,9 @@ protected:
   void CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height) override;
   void FlushRender() override;
   void MapBatchVertexPointer(u32 required_vertices) override;
-  void UpdateVRAMReadTexture() override;
+  void UpdateVRAMReadTexture(const Common::Rectangle<u32>& rect) override;
+  bool SaveVRAMBackup() override;
+  void RestoreVRAMBackup() override;
 
 private:
   struct GLStats
@@ -58,6 +60,7 @@ private:
   GL::Texture m_vram_read_texture;
   GL::Texture m_vram_encoding_texture;
   GL::Texture m_display_texture;
+  GL::Texture m_vram_backup_texture;
 
   std::vector<BatchVertex> m_vertex_buffer;
 
@@ -1,44 +1,532 @@
 #include "gte.h"
+#include "common/cpu_detect.h"
 #include <algorithm>
 #include <array>
+#include <cstring>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#if defined(CPU_X64)
+#include <emmintrin.h>
+#elif defined(CPU_AARCH64)
+#include <arm_neon.h>
+#endif
+
+static ALWAYS_INLINE u32 CountLeadingZeros(u32 value)
+{
+  // The intrinsics are undefined for zero.
+  if (value == 0)
+    return 32;
+
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanReverse(&index, value);
+  return 31 - static_cast<u32>(index);
+#else
+  return static_cast<u32>(__builtin_clz(value));
+#endif
+}
+
+static ALWAYS_INLINE u32 CountLeadingBits(u32 value)
+{
+  // Leading ones for negative values, otherwise leading zeros.
+  return CountLeadingZeros((static_cast<s32>(value) < 0) ? ~value : value);
+}
+
+namespace GTE {
+
+// UNR reciprocal table, max(0, (40000h/(i+100h)+1)/2-101h), with one extra entry for "(d-7FC0h)/80h"=100h.
+static constexpr std::array<u8, 257> GenerateUNRTable()
+{
+  std::array<u8, 257> table = {};
+  for (u32 i = 0; i < table.size(); i++)
+    table[i] = static_cast<u8>(std::max<s32>(0, static_cast<s32>((0x40000 / (i + 0x100) + 1) / 2) - 0x101));
+
+  return table;
+}
+
+static constexpr std::array<u8, 257> s_unr_table = GenerateUNRTable();
+
+// Divides lhs (H) by rhs (SZ3), without the overflow check.
+static ALWAYS_INLINE u32 UNRDivideNoOverflow(u32 lhs, u32 rhs)
+{
+  // Leading zeros of the 16-bit divisor, 16 if it is zero.
+  const u32 shift = CountLeadingZeros((rhs << 16) | 0x8000);
+  lhs <<= shift;
+  rhs <<= shift;
+
+  const u32 divisor = rhs | 0x8000;
+  const s32 x = static_cast<s32>(0x101 + ZeroExtend32(s_unr_table[((divisor & 0x7FFF) + 0x40) >> 7]));
+  const s32 d = ((static_cast<s32>(ZeroExtend32(divisor)) * -x) + 0x80) >> 8;
+  const u32 recip = static_cast<u32>(((x * (0x20000 + d)) + 0x80) >> 8);
+
+  const u32 result = Truncate32((ZeroExtend64(lhs) * ZeroExtend64(recip) + u64(0x8000)) >> 16);
+
+  // The min(1FFFFh) limit is needed for cases like FE3Fh/7F20h, F015h/780Bh, etc. (these do produce UNR result 20000h,
+  // and are saturated to 1FFFFh, but without setting overflow FLAG bits).
+  return std::min<u32>(0x1FFFF, result);
+}
+
+// The helpers below process the three components (x/y/z or r/g/b) of a vector at once. Vector3 holds 32-bit values,
+// and MACVector3 holds the up-to-44-bit sums, with enough headroom to detect overflow. The fourth lane of the SIMD
+// versions is unused. Overflow and saturation are accumulated per component in ComponentFlags, and only converted to
+// FLAG bits once the instruction is complete.
+#if defined(CPU_X64)
+
+using Vector3 = __m128i;
+
+// SSE2 has no 64-bit compares or arithmetic shifts, so the sums are split into low and high words.
+struct MACVector3
+{
+  __m128i lo;
+  __m128i hi;
+};
+
+struct ComponentFlags
+{
+  __m128i mac_overflow = _mm_setzero_si128();
+  __m128i mac_underflow = _mm_setzero_si128();
+  __m128i ir_saturated = _mm_setzero_si128();
+  __m128i color_saturated = _mm_setzero_si128();
+};
+
+static ALWAYS_INLINE Vector3 LoadVector3(s32 x, s32 y, s32 z)
+{
+  return _mm_setr_epi32(x, y, z, 0);
+}
+
+static ALWAYS_INLINE Vector3 BroadcastValue(s32 value)
+{
+  return _mm_set1_epi32(value);
+}
+
+template<u32 index>
+static ALWAYS_INLINE Vector3 BroadcastComponent(Vector3 v)
+{
+  return _mm_shuffle_epi32(v, _MM_SHUFFLE(index, index, index, index));
+}
+
+// x and y from the first vector, z from the second.
+static ALWAYS_INLINE Vector3 CombineXYZ(Vector3 xy, Vector3 z)
+{
+  return _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(xy), _mm_castsi128_ps(z), _MM_SHUFFLE(3, 2, 1, 0)));
+}
+
+static ALWAYS_INLINE void StoreVector3(s32* out, Vector3 v)
+{
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(out), v);
+  out[2] = _mm_cvtsi128_si32(_mm_unpackhi_epi64(v, v));
+}
+
+// Both operands must be within the 16-bit range.
+static ALWAYS_INLINE Vector3 MulS16(Vector3 a, Vector3 b)
+{
+  return _mm_madd_epi16(a, _mm_and_si128(b, _mm_set1_epi32(0xFFFF)));
+}
+
+template<u32 shift>
+static ALWAYS_INLINE Vector3 ShiftRight(Vector3 v)
+{
+  return _mm_srai_epi32(v, shift);
+}
+
+static ALWAYS_INLINE MACVector3 ExtendMAC(Vector3 v)
+{
+  return {v, _mm_srai_epi32(v, 31)};
+}
+
+static ALWAYS_INLINE MACVector3 ExtendMACShiftLeft12(Vector3 v)
+{
+  return {_mm_slli_epi32(v, 12), _mm_srai_epi32(v, 20)};
+}
+
+static ALWAYS_INLINE MACVector3 AddMAC(const MACVector3& a, const MACVector3& b)
+{
+  // Carry out of the low word if the unsigned result is smaller than the first operand.
+  const __m128i sign = _mm_set1_epi32(INT32_MIN);
+  const __m128i lo = _mm_add_epi32(a.lo, b.lo);
+  const __m128i carry = _mm_cmpgt_epi32(_mm_xor_si128(a.lo, sign), _mm_xor_si128(lo, sign));
+  return {lo, _mm_sub_epi32(_mm_add_epi32(a.hi, b.hi), carry)};
+}
+
+static ALWAYS_INLINE MACVector3 SubMAC(const MACVector3& a, const MACVector3& b)
+{
+  const __m128i sign = _mm_set1_epi32(INT32_MIN);
+  const __m128i borrow = _mm_cmpgt_epi32(_mm_xor_si128(b.lo, sign), _mm_xor_si128(a.lo, sign));
+  return {_mm_sub_epi32(a.lo, b.lo), _mm_add_epi32(_mm_sub_epi32(a.hi, b.hi), borrow)};
+}
+
+static ALWAYS_INLINE MACVector3 SignExtendMAC(const MACVector3& v)
+{
+  return {v.lo, _mm_srai_epi32(_mm_slli_epi32(v.hi, 20), 20)};
+}
+
+static ALWAYS_INLINE Vector3 ShiftRightMAC(const MACVector3& v, u8 shift)
+{
+  // Shifting by 32 gives zero, so this also works when shift is zero.
+  return _mm_or_si128(_mm_srl_epi32(v.lo, _mm_cvtsi32_si128(shift)),
+                      _mm_sll_epi32(v.hi, _mm_cvtsi32_si128(32 - shift)));
+}
+
+static ALWAYS_INLINE void CheckMACOverflow(const MACVector3& v, ComponentFlags* flags)
+{
+  // -2^43..2^43-1 is exactly the range where the high word is within -800h..7FFh.
+  flags->mac_overflow = _mm_or_si128(flags->mac_overflow, _mm_cmpgt_epi32(v.hi, _mm_set1_epi32(0x7FF)));
+  flags->mac_underflow = _mm_or_si128(flags->mac_underflow, _mm_cmplt_epi32(v.hi, _mm_set1_epi32(-0x800)));
+}
+
+// Clamps to min_value..7FFFh, where min_value is 0 or -8000h.
+static ALWAYS_INLINE Vector3 ClampIR(Vector3 v, Vector3 min_value)
+{
+  const __m128i ir16 = _mm_max_epi16(_mm_packs_epi32(v, v), _mm_packs_epi32(min_value, min_value));
+  return _mm_srai_epi32(_mm_unpacklo_epi16(ir16, ir16), 16);
+}
+
+static ALWAYS_INLINE Vector3 SaturateIR(Vector3 v, Vector3 min_value, ComponentFlags* flags)
+{
+  const __m128i ir = ClampIR(v, min_value);
+  flags->ir_saturated = _mm_or_si128(flags->ir_saturated, _mm_xor_si128(_mm_cmpeq_epi32(ir, v), _mm_set1_epi32(-1)));
+  return ir;
+}
+
+static ALWAYS_INLINE u32 SaturateColor(Vector3 v, ComponentFlags* flags)
+{
+  const __m128i rgb8 = _mm_packus_epi16(_mm_packs_epi32(v, v), _mm_setzero_si128());
+  const __m128i rgb = _mm_unpacklo_epi16(_mm_unpacklo_epi8(rgb8, _mm_setzero_si128()), _mm_setzero_si128());
+  flags->color_saturated =
+    _mm_or_si128(flags->color_saturated, _mm_xor_si128(_mm_cmpeq_epi32(rgb, v), _mm_set1_epi32(-1)));
+  return static_cast<u32>(_mm_cvtsi128_si32(rgb8)) & UINT32_C(0xFFFFFF);
+}
+
+static ALWAYS_INLINE u32 GetComponentMask(__m128i mask)
+{
+  // The first component is the highest bit in FLAG.
+  const u32 bits = static_cast<u32>(_mm_movemask_ps(_mm_castsi128_ps(mask)));
+  return ((bits & 1) << 2) | (bits & 2) | ((bits >> 2) & 1);
+}
+
+static ALWAYS_INLINE u32 GetFlagBits(const ComponentFlags& flags)
+{
+  return (GetComponentMask(flags.mac_overflow) << 28) | (GetComponentMask(flags.mac_underflow) << 25) |
+         (GetComponentMask(flags.ir_saturated) << 22) | (GetComponentMask(flags.color_saturated) << 19);
+}
+
+#elif defined(CPU_AARCH64)
+
+using Vector3 = int32x4_t;
+
+// Split into low and high words, the same as the SSE2 version.
+struct MACVector3
+{
+  int32x4_t lo;
+  int32x4_t hi;
+};
+
+struct ComponentFlags
+{
+  uint32x4_t mac_overflow = vdupq_n_u32(0);
+  uint32x4_t mac_underflow = vdupq_n_u32(0);
+  uint32x4_t ir_saturated = vdupq_n_u32(0);
+  uint32x4_t color_saturated = vdupq_n_u32(0);
+};
+
+static ALWAYS_INLINE Vector3 LoadVector3(s32 x, s32 y, s32 z)
+{
+  const s32 values[4] = {x, y, z, 0};
+  return vld1q_s32(values);
+}
+
+static ALWAYS_INLINE Vector3 BroadcastValue(s32 value)
+{
+  return vdupq_n_s32(value);
+}
+
+template<u32 index>
+static ALWAYS_INLINE Vector3 BroadcastComponent(Vector3 v)
+{
+  return vdupq_laneq_s32(v, index);
+}
+
+static ALWAYS_INLINE Vector3 CombineXYZ(Vector3 xy, Vector3 z)
+{
+  return vcopyq_laneq_s32(xy, 2, z, 2);
+}
+
+static ALWAYS_INLINE void StoreVector3(s32* out, Vector3 v)
+{
+  vst1_s32(out, vget_low_s32(v));
+  out[2] = vgetq_lane_s32(v, 2);
+}
+
+static ALWAYS_INLINE Vector3 MulS16(Vector3 a, Vector3 b)
+{
+  return vmulq_s32(a, b);
+}
+
+template<u32 shift>
+static ALWAYS_INLINE Vector3 ShiftRight(Vector3 v)
+{
+  return vshrq_n_s32(v, shift);
+}
+
+static ALWAYS_INLINE MACVector3 ExtendMAC(Vector3 v)
+{
+  return {v, vshrq_n_s32(v, 31)};
+}
+
+static ALWAYS_INLINE MACVector3 ExtendMACShiftLeft12(Vector3 v)
+{
+  return {vshlq_n_s32(v, 12), vshrq_n_s32(v, 20)};
+}
+
+static ALWAYS_INLINE MACVector3 AddMAC(const MACVector3& a, const MACVector3& b)
+{
+  const int32x4_t lo = vaddq_s32(a.lo, b.lo);
+  const uint32x4_t carry = vcltq_u32(vreinterpretq_u32_s32(lo), vreinterpretq_u32_s32(a.lo));
+  return {lo, vsubq_s32(vaddq_s32(a.hi, b.hi), vreinterpretq_s32_u32(carry))};
+}
+
+static ALWAYS_INLINE MACVector3 SubMAC(const MACVector3& a, const MACVector3& b)
+{
+  const uint32x4_t borrow = vcltq_u32(vreinterpretq_u32_s32(a.lo), vreinterpretq_u32_s32(b.lo));
+  return {vsubq_s32(a.lo, b.lo), vaddq_s32(vsubq_s32(a.hi, b.hi), vreinterpretq_s32_u32(borrow))};
+}
+
+static ALWAYS_INLINE MACVector3 SignExtendMAC(const MACVector3& v)
+{
+  return {v.lo, vshrq_n_s32(vshlq_n_s32(v.hi, 20), 20)};
+}
+
+static ALWAYS_INLINE Vector3 ShiftRightMAC(const MACVector3& v, u8 shift)
+{
+  const uint32x4_t lo = vshlq_u32(vreinterpretq_u32_s32(v.lo), vdupq_n_s32(-static_cast<s32>(shift)));
+  return vorrq_s32(vreinterpretq_s32_u32(lo), vshlq_s32(v.hi, vdupq_n_s32(32 - static_cast<s32>(shift))));
+}
+
+static ALWAYS_INLINE void CheckMACOverflow(const MACVector3& v, ComponentFlags* flags)
+{
+  flags->mac_overflow = vorrq_u32(flags->mac_overflow, vcgtq_s32(v.hi, vdupq_n_s32(0x7FF)));
+  flags->mac_underflow = vorrq_u32(flags->mac_underflow, vcltq_s32(v.hi, vdupq_n_s32(-0x800)));
+}
+
+static ALWAYS_INLINE Vector3 ClampIR(Vector3 v, Vector3 min_value)
+{
+  return vmaxq_s32(vmovl_s16(vqmovn_s32(v)), min_value);
+}
+
+static ALWAYS_INLINE Vector3 SaturateIR(Vector3 v, Vector3 min_value, ComponentFlags* flags)
+{
+  const int32x4_t ir = ClampIR(v, min_value);
+  flags->ir_saturated = vorrq_u32(flags->ir_saturated, vmvnq_u32(vceqq_s32(ir, v)));
+  return ir;
+}
+
+static ALWAYS_INLINE u32 SaturateColor(Vector3 v, ComponentFlags* flags)
+{
+  const int32x4_t rgb = vminq_s32(vmaxq_s32(v, vdupq_n_s32(0)), vdupq_n_s32(0xFF));
+  flags->color_saturated = vorrq_u32(flags->color_saturated, vmvnq_u32(vceqq_s32(rgb, v)));
+  return static_cast<u32>(vgetq_lane_s32(rgb, 0)) | (static_cast<u32>(vgetq_lane_s32(rgb, 1)) << 8) |
+         (static_cast<u32>(vgetq_lane_s32(rgb, 2)) << 16);
+}
+
+static ALWAYS_INLINE u32 GetComponentMask(uint32x4_t mask)
+{
+  static constexpr u32 bits[4] = {4, 2, 1, 0};
+  return vaddvq_u32(vandq_u32(mask, vld1q_u32(bits)));
+}
+
+static ALWAYS_INLINE u32 GetFlagBits(const ComponentFlags& flags)
+{
+  return (GetComponentMask(flags.mac_overflow) << 28) | (GetComponentMask(flags.mac_underflow) << 25) |
+         (GetComponentMask(flags.ir_saturated) << 22) | (GetComponentMask(flags.color_saturated) << 19);
+}
+
+#else
+
+struct Vector3
+{
+  s32 c[3];
+};
+
+struct MACVector3
+{
+  s64 c[3];
+};
+
+struct ComponentFlags
+{
+  u32 bits = 0;
+};
+
+static ALWAYS_INLINE Vector3 LoadVector3(s32 x, s32 y, s32 z)
+{
+  return {{x, y, z}};
+}
+
+static ALWAYS_INLINE Vector3 BroadcastValue(s32 value)
+{
+  return {{value, value, value}};
+}
+
+template<u32 index>
+static ALWAYS_INLINE Vector3 BroadcastComponent(Vector3 v)
+{
+  return {{v.c[index], v.c[index], v.c[index]}};
+}
 
-// TODO: Optimize, intrinsics?
-static inline constexpr u32 CountLeadingZeros(u16 value)
+static ALWAYS_INLINE Vector3 CombineXYZ(Vector3 xy, Vector3 z)
 {
-  u32 count = 0;
-  for (u32 i = 0; i < 16 && (value & UINT16_C(0x8000)) == 0; i++)
+  return {{xy.c[0], xy.c[1], z.c[2]}};
+}
+
+static ALWAYS_INLINE void StoreVector3(s32* out, Vector3 v)
+{
+  std::copy_n(v.c, 3, out);
+}
+
+static ALWAYS_INLINE Vector3 MulS16(Vector3 a, Vector3 b)
+{
+  return {{a.c[0] * b.c[0], a.c[1] * b.c[1], a.c[2] * b.c[2]}};
+}
+
+template<u32 shift>
+static ALWAYS_INLINE Vector3 ShiftRight(Vector3 v)
+{
+  return {{v.c[0] >> shift, v.c[1] >> shift, v.c[2] >> shift}};
+}
+
+static ALWAYS_INLINE MACVector3 ExtendMAC(Vector3 v)
+{
+  return {{s64(v.c[0]), s64(v.c[1]), s64(v.c[2])}};
+}
+
+static ALWAYS_INLINE MACVector3 ExtendMACShiftLeft12(Vector3 v)
+{
+  return {{s64(v.c[0]) << 12, s64(v.c[1]) << 12, s64(v.c[2]) << 12}};
+}
+
+static ALWAYS_INLINE MACVector3 AddMAC(const MACVector3& a, const MACVector3& b)
+{
+  return {{a.c[0] + b.c[0], a.c[1] + b.c[1], a.c[2] + b.c[2]}};
+}
+
+static ALWAYS_INLINE MACVector3 SubMAC(const MACVector3& a, const MACVector3& b)
+{
+  return {{a.c[0] - b.c[0], a.c[1] - b.c[1], a.c[2] - b.c[2]}};
+}
+
+static ALWAYS_INLINE MACVector3 SignExtendMAC(const MACVector3& v)
+{
+  return {{SignExtendN<44>(v.c[0]), SignExtendN<44>(v.c[1]), SignExtendN<44>(v.c[2])}};
+}
+
+static ALWAYS_INLINE Vector3 ShiftRightMAC(const MACVector3& v, u8 shift)
+{
+  return {{static_cast<s32>(v.c[0] >> shift), static_cast<s32>(v.c[1] >> shift), static_cast<s32>(v.c[2] >> shift)}};
+}
+
+static ALWAYS_INLINE void CheckMACOverflow(const MACVector3& v, ComponentFlags* flags)
+{
+  for (u32 i = 0; i < 3; i++)
   {
-    count++;
-    value <<= 1;
+    if (v.c[i] < -(INT64_C(1) << 43))
+      flags->bits |= UINT32_C(1) << (27 - i);
+    else if (v.c[i] > ((INT64_C(1) << 43) - 1))
+      flags->bits |= UINT32_C(1) << (30 - i);
   }
+}
 
-  return count;
+static ALWAYS_INLINE Vector3 ClampIR(Vector3 v, Vector3 min_value)
+{
+  return {{std::clamp<s32>(v.c[0], min_value.c[0], 0x7FFF), std::clamp<s32>(v.c[1], min_value.c[1], 0x7FFF),
+           std::clamp<s32>(v.c[2], min_value.c[2], 0x7FFF)}};
 }
 
-static inline constexpr u32 CountLeadingBits(u32 value)
+static ALWAYS_INLINE Vector3 SaturateIR(Vector3 v, Vector3 min_value, ComponentFlags* flags)
 {
-  u32 count = 0;
-  if ((value & UINT32_C(0x80000000)) != 0)
+  const Vector3 ir = ClampIR(v, min_value);
+  for (u32 i = 0; i < 3; i++)
   {
-    for (u32 i = 0; i < 32 && ((value & UINT32_C(0x80000000)) != 0); i++)
-    {
-      count++;
-      value <<= 1;
-    }
+    if (ir.c[i] != v.c[i])
+      flags->bits |= UINT32_C(1) << (24 - i);
   }
-  else
+
+  return ir;
+}
+
+static ALWAYS_INLINE u32 SaturateColor(Vector3 v, ComponentFlags* flags)
+{
+  u32 rgb = 0;
+  for (u32 i = 0; i < 3; i++)
   {
-    for (u32 i = 0; i < 32 && (value & UINT32_C(0x80000000)) == 0; i++)
-    {
-      count++;
-      value <<= 1;
-    }
+    const s32 value = std::clamp<s32>(v.c[i], 0, 0xFF);
+    if (value != v.c[i])
+      flags->bits |= UINT32_C(1) << (21 - i);
+
+    rgb |= static_cast<u32>(value) << (i * 8);
   }
 
-  return count;
+  return rgb;
 }
 
-namespace GTE {
+static ALWAYS_INLINE u32 GetFlagBits(const ComponentFlags& flags)
+{
+  return flags.bits;
+}
+
+#endif
+
+static ALWAYS_INLINE Vector3 LoadMatrixColumn(const s16 M[3][3], u32 column)
+{
+  return LoadVector3(M[0][column], M[1][column], M[2][column]);
+}
+
+static ALWAYS_INLINE Vector3 GetIRMinValue(bool lm)
+{
+  return BroadcastValue(lm ? 0 : -0x8000);
+}
+
+// (T SHL 12) + M*V, with V as broadcast components. Like the hardware, overflow is checked after each column, and the
+// first two partial sums are truncated to 44 bits.
+static ALWAYS_INLINE MACVector3 MulMatVecMAC(const Vector3 M[3], const MACVector3& T, Vector3 Vx, Vector3 Vy,
+                                             Vector3 Vz, ComponentFlags* flags)
+{
+  MACVector3 sum = AddMAC(T, ExtendMAC(MulS16(M[0], Vx)));
+  CheckMACOverflow(sum, flags);
+  sum = AddMAC(SignExtendMAC(sum), ExtendMAC(MulS16(M[1], Vy)));
+  CheckMACOverflow(sum, flags);
+  sum = AddMAC(SignExtendMAC(sum), ExtendMAC(MulS16(M[2], Vz)));
+  CheckMACOverflow(sum, flags);
+  return sum;
+}
+
+// MAC+(FC-MAC)*IR0, where fc is FC SHL 12 and ir0 is IR0 in all components. Returns IR, with MAC in *mac.
+static ALWAYS_INLINE Vector3 InterpolateColorVector(const MACVector3& fc, Vector3 ir0, Vector3 in_mac, u8 shift,
+                                                    Vector3 ir_min_value, Vector3* mac, ComponentFlags* flags)
+{
+  // [IR1,IR2,IR3] = (([RFC,GFC,BFC] SHL 12) - [MAC1,MAC2,MAC3]) SAR (sf*12)
+  const MACVector3 in = ExtendMAC(in_mac);
+  const MACVector3 diff = SubMAC(fc, in);
+  CheckMACOverflow(diff, flags);
+  const Vector3 ir = SaturateIR(ShiftRightMAC(diff, shift), GetIRMinValue(false), flags);
+
+  // [MAC1,MAC2,MAC3] = (([IR1,IR2,IR3] * IR0) + [MAC1,MAC2,MAC3]) SAR (sf*12)
+  const MACVector3 sum = AddMAC(ExtendMAC(MulS16(ir, ir0)), in);
+  CheckMACOverflow(sum, flags);
+  *mac = ShiftRightMAC(sum, shift);
+  return SaturateIR(*mac, ir_min_value, flags);
+}
+
+static ALWAYS_INLINE const s16* GetVertex(const Regs& regs, u32 index)
+{
+  return (index == 0) ? regs.V0 : ((index == 1) ? regs.V1 : regs.V2);
+}
+
+static ALWAYS_INLINE void StoreMACAndIR(Regs& regs, Vector3 mac, Vector3 ir)
+{
+  StoreVector3(reinterpret_cast<s32*>(&regs.dr32[25]), mac);
+  StoreVector3(reinterpret_cast<s32*>(&regs.dr32[9]), ir);
+}
 
 Core::Core() = default;
 
@@ -347,14 +835,18 @@ void Core::PushSZ(s32 value)
 void Core::PushRGBFromMAC()
 {
   // Note: SHR 4 used instead of /16 as the results are different.
-  const u32 r = TruncateRGB<0>(static_cast<u32>(m_regs.MAC1 >> 4));
-  const u32 g = TruncateRGB<1>(static_cast<u32>(m_regs.MAC2 >> 4));
-  const u32 b = TruncateRGB<2>(static_cast<u32>(m_regs.MAC3 >> 4));
+  ComponentFlags flags;
+  PushRGB(SaturateColor(ShiftRight<4>(LoadVector3(m_regs.MAC1, m_regs.MAC2, m_regs.MAC3)), &flags));
+  m_regs.FLAG.bits |= GetFlagBits(flags);
+}
+
+void Core::PushRGB(u32 rgb)
+{
   const u32 c = ZeroExtend32(m_regs.RGBC[3]);
 
-  m_regs.dr32[20] = m_regs.dr32[21];                      // RGB0 <- RGB1
-  m_regs.dr32[21] = m_regs.dr32[22];                      // RGB1 <- RGB2
-  m_regs.dr32[22] = r | (g << 8) | (b << 16) | (c << 24); // RGB2 <- Value
+  m_regs.dr32[20] = m_regs.dr32[21];  // RGB0 <- RGB1
+  m_regs.dr32[21] = m_regs.dr32[22];  // RGB1 <- RGB2
+  m_regs.dr32[22] = rgb | (c << 24); // RGB2 <- Value
 }
 
 u32 Core::UNRDivide(u32 lhs, u32 rhs)
@@ -365,70 +857,35 @@ u32 Core::UNRDivide(u32 lhs, u32 rhs)
     return 0x1FFFF;
   }
 
-  const u32 shift = CountLeadingZeros(static_cast<u16>(rhs));
-  lhs <<= shift;
-  rhs <<= shift;
-
-  static constexpr std::array<u8, 257> unr_table = {{
-    0xFF, 0xFD, 0xFB, 0xF9, 0xF7, 0xF5, 0xF3, 0xF1, 0xEF, 0xEE, 0xEC, 0xEA, 0xE8, 0xE6, 0xE4, 0xE3, //
-    0xE1, 0xDF, 0xDD, 0xDC, 0xDA, 0xD8, 0xD6, 0xD5, 0xD3, 0xD1, 0xD0, 0xCE, 0xCD, 0xCB, 0xC9, 0xC8, //  00h..3Fh
-    0xC6, 0xC5, 0xC3, 0xC1, 0xC0, 0xBE, 0xBD, 0xBB, 0xBA, 0xB8, 0xB7, 0xB5, 0xB4, 0xB2, 0xB1, 0xB0, //
-    0xAE, 0xAD, 0xAB, 0xAA, 0xA9, 0xA7, 0xA6, 0xA4, 0xA3, 0xA2, 0xA0, 0x9F, 0x9E, 0x9C, 0x9B, 0x9A, //
-    0x99, 0x97, 0x96, 0x95, 0x94, 0x92, 0x91, 0x90, 0x8F, 0x8D, 0x8C, 0x8B, 0x8A, 0x89, 0x87, 0x86, //
-    0x85, 0x84, 0x83, 0x82, 0x81, 0x7F, 0x7E, 0x7D, 0x7C, 0x7B, 0x7A, 0x79, 0x78, 0x77, 0x75, 0x74, //  40h..7Fh
-    0x73, 0x72, 0x71, 0x70, 0x6F, 0x6E, 0x6D, 0x6C, 0x6B, 0x6A, 0x69, 0x68, 0x67, 0x66, 0x65, 0x64, //
-    0x63, 0x62, 0x61, 0x60, 0x5F, 0x5E, 0x5D, 0x5D, 0x5C, 0x5B, 0x5A, 0x59, 0x58, 0x57, 0x56, 0x55, //
-    0x54, 0x53, 0x53, 0x52, 0x51, 0x50, 0x4F, 0x4E, 0x4D, 0x4D, 0x4C, 0x4B, 0x4A, 0x49, 0x48, 0x48, //
-    0x47, 0x46, 0x45, 0x44, 0x43, 0x43, 0x42, 0x41, 0x40, 0x3F, 0x3F, 0x3E, 0x3D, 0x3C, 0x3C, 0x3B, //  80h..BFh
-    0x3A, 0x39, 0x39, 0x38, 0x37, 0x36, 0x36, 0x35, 0x34, 0x33, 0x33, 0x32, 0x31, 0x31, 0x30, 0x2F, //
-    0x2E, 0x2E, 0x2D, 0x2C, 0x2C, 0x2B, 0x2A, 0x2A, 0x29, 0x28, 0x28, 0x27, 0x26, 0x26, 0x25, 0x24, //
-    0x24, 0x23, 0x22, 0x22, 0x21, 0x20, 0x20, 0x1F, 0x1E, 0x1E, 0x1D, 0x1D, 0x1C, 0x1B, 0x1B, 0x1A, //
-    0x19, 0x19, 0x18, 0x18, 0x17, 0x16, 0x16, 0x15, 0x15, 0x14, 0x14, 0x13, 0x12, 0x12, 0x11, 0x11, //  C0h..FFh
-    0x10, 0x0F, 0x0F, 0x0E, 0x0E, 0x0D, 0x0D, 0x0C, 0x0C, 0x0B, 0x0A, 0x0A, 0x09, 0x09, 0x08, 0x08, //
-    0x07, 0x07, 0x06, 0x06, 0x05, 0x05, 0x04, 0x04, 0x03, 0x03, 0x02, 0x02, 0x01, 0x01, 0x00, 0x00, //
-    0x00 // <-- one extra table entry (for "(d-7FC0h)/80h"=100h)
-  }};
-
-  const u32 divisor = rhs | 0x8000;
-  const s32 x = static_cast<s32>(0x101 + ZeroExtend32(unr_table[((divisor & 0x7FFF) + 0x40) >> 7]));
-  const s32 d = ((static_cast<s32>(ZeroExtend32(divisor)) * -x) + 0x80) >> 8;
-  const u32 recip = static_cast<u32>(((x * (0x20000 + d)) + 0x80) >> 8);
-
-  const u32 result = Truncate32((ZeroExtend64(lhs) * ZeroExtend64(recip) + u64(0x8000)) >> 16);
-
-  // The min(1FFFFh) limit is needed for cases like FE3Fh/7F20h, F015h/780Bh, etc. (these do produce UNR result 20000h,
-  // and are saturated to 1FFFFh, but without setting overflow FLAG bits).
-  return std::min<u32>(0x1FFFF, result);
+  return UNRDivideNoOverflow(lhs, rhs);
 }
 
-void Core::MulMatVec(const s16 M[3][3], const s16 Vx, const s16 Vy, const s16 Vz, u8 shift, bool lm)
+void Core::UNRDivide3(u32 lhs, const u32 rhs[3], u32 results[3])
 {
-#define dot3(i)                                                                                                        \
-  TruncateAndSetMACAndIR<i + 1>(SignExtendMACResult<i + 1>((s64(M[i][0]) * s64(Vx)) + (s64(M[i][1]) * s64(Vy))) +      \
-                                  (s64(M[i][2]) * s64(Vz)),                                                            \
-                                shift, lm)
-
-  dot3(0);
-  dot3(1);
-  dot3(2);
+  // The divisions are independent, so keep them free of branches and let them overlap.
+  bool overflow = false;
+  for (u32 i = 0; i < 3; i++)
+  {
+    const bool vertex_overflow = (rhs[i] * 2 <= lhs);
+    const u32 result = UNRDivideNoOverflow(lhs, rhs[i]);
+    results[i] = vertex_overflow ? 0x1FFFF : result;
+    overflow |= vertex_overflow;
+  }
 
-#undef dot3
+  if (overflow)
+    m_regs.FLAG.divide_overflow = true;
 }
 
 void Core::MulMatVec(const s16 M[3][3], const s32 T[3], const s16 Vx, const s16 Vy, const s16 Vz, u8 shift, bool lm)
 {
-#define dot3(i)                                                                                                        \
-  TruncateAndSetMACAndIR<i + 1>(                                                                                       \
-    SignExtendMACResult<i + 1>(SignExtendMACResult<i + 1>((s64(T[i]) << 12) + (s64(M[i][0]) * s64(Vx))) +              \
-                               (s64(M[i][1]) * s64(Vy))) +                                                             \
-      (s64(M[i][2]) * s64(Vz)),                                                                                        \
-    shift, lm)
-
-  dot3(0);
-  dot3(1);
-  dot3(2);
-
-#undef dot3
+  const Vector3 columns[3] = {LoadMatrixColumn(M, 0), LoadMatrixColumn(M, 1), LoadMatrixColumn(M, 2)};
+  ComponentFlags flags;
+
+  const MACVector3 sum = MulMatVecMAC(columns, ExtendMACShiftLeft12(LoadVector3(T[0], T[1], T[2])),
+                                      BroadcastValue(Vx), BroadcastValue(Vy), BroadcastValue(Vz), &flags);
+  const Vector3 mac = ShiftRightMAC(sum, shift);
+  StoreMACAndIR(m_regs, mac, SaturateIR(mac, GetIRMinValue(lm), &flags));
+  m_regs.FLAG.bits |= GetFlagBits(flags);
 }
 
 void Core::Execute_MVMVA(Instruction inst)
@@ -552,72 +1009,93 @@ void Core::Execute_OP(Instruction inst)
   m_regs.FLAG.UpdateError();
 }
 
-void Core::RTPS(const s16 V[3], u8 shift, bool lm, bool last)
+template<u32 num_vertices>
+void Core::RTP(u8 shift, bool lm)
 {
-#define dot3(i)                                                                                                        \
-  SignExtendMACResult<i + 1>(                                                                                          \
-    SignExtendMACResult<i + 1>((s64(m_regs.TR[i]) << 12) + (s64(m_regs.RT[i][0]) * s64(V[0]))) +                       \
-    (s64(m_regs.RT[i][1]) * s64(V[1]))) +                                                                              \
-    (s64(m_regs.RT[i][2]) * s64(V[2]))
+  const Vector3 rt[3] = {LoadMatrixColumn(m_regs.RT, 0), LoadMatrixColumn(m_regs.RT, 1),
+                         LoadMatrixColumn(m_regs.RT, 2)};
+  const MACVector3 tr = ExtendMACShiftLeft12(LoadVector3(m_regs.TR[0], m_regs.TR[1], m_regs.TR[2]));
+  const Vector3 ir_min_value = GetIRMinValue(lm);
+  const Vector3 ir_flag_min_value = LoadVector3(lm ? 0 : -0x8000, lm ? 0 : -0x8000, -0x8000);
+  ComponentFlags flags;
+
+  // The vertices don't depend on each other, so transform them all before projecting.
+  Vector3 mac[3];
+  Vector3 ir[3];
+  s32 sz[3];
+  for (u32 i = 0; i < num_vertices; i++)
+  {
+    // IR1 = MAC1 = (TRX*1000h + RT11*VX0 + RT12*VY0 + RT13*VZ0) SAR (sf*12)
+    // IR2 = MAC2 = (TRY*1000h + RT21*VX0 + RT22*VY0 + RT23*VZ0) SAR (sf*12)
+    // IR3 = MAC3 = (TRZ*1000h + RT31*VX0 + RT32*VY0 + RT33*VZ0) SAR (sf*12)
+    const s16* V = GetVertex(m_regs, i);
+    const MACVector3 sum =
+      MulMatVecMAC(rt, tr, BroadcastValue(V[0]), BroadcastValue(V[1]), BroadcastValue(V[2]), &flags);
+    mac[i] = ShiftRightMAC(sum, shift);
+
+    // The command does saturate IR1,IR2,IR3 to -8000h..+7FFFh (regardless of lm bit). When using RTP with sf=0, then
+    // the IR3 saturation flag (FLAG.22) gets set <only> if "MAC3 SAR 12" exceeds -8000h..+7FFFh (although IR3 is
+    // saturated when "MAC3" exceeds -8000h..+7FFFh).
+    const Vector3 z = ShiftRightMAC(sum, 12);
+    ir[i] = ClampIR(mac[i], ir_min_value);
+    SaturateIR(CombineXYZ(mac[i], z), ir_flag_min_value, &flags);
+
+    s32 z_values[3];
+    StoreVector3(z_values, z);
+    sz[i] = z_values[2];
+  }
 
-  // IR1 = MAC1 = (TRX*1000h + RT11*VX0 + RT12*VY0 + RT13*VZ0) SAR (sf*12)
-  // IR2 = MAC2 = (TRY*1000h + RT21*VX0 + RT22*VY0 + RT23*VZ0) SAR (sf*12)
-  // IR3 = MAC3 = (TRZ*1000h + RT31*VX0 + RT32*VY0 + RT33*VZ0) SAR (sf*12)
-  const s64 x = dot3(0);
-  const s64 y = dot3(1);
-  const s64 z = dot3(2);
-  TruncateAndSetMAC<1>(x, shift);
-  TruncateAndSetMAC<2>(y, shift);
-  TruncateAndSetMAC<3>(z, shift);
-  TruncateAndSetIR<1>(m_regs.MAC1, lm);
-  TruncateAndSetIR<2>(m_regs.MAC2, lm);
+  // SZ3 = MAC3 SAR ((1-sf)*12)                           ;ScreenZ FIFO 0..+FFFFh
+  u32 divisors[num_vertices];
+  for (u32 i = 0; i < num_vertices; i++)
+  {
+    PushSZ(sz[i]);
+    divisors[i] = m_regs.SZ3;
+  }
 
-  // The command does saturate IR1,IR2,IR3 to -8000h..+7FFFh (regardless of lm bit). When using RTP with sf=0, then the
-  // IR3 saturation flag (FLAG.22) gets set <only> if "MAC3 SAR 12" exceeds -8000h..+7FFFh (although IR3 is saturated
-  // when "MAC3" exceeds -8000h..+7FFFh).
-  TruncateAndSetIR<3>(s32(z >> 12), false);
-  m_regs.dr32[11] = std::clamp(m_regs.MAC3, lm ? 0 : IR123_MIN_VALUE, IR123_MAX_VALUE);
-#undef dot3
+  u32 quotients[num_vertices];
+  if constexpr (num_vertices == 3)
+    UNRDivide3(m_regs.H, divisors, quotients);
+  else
+    quotients[0] = UNRDivide(m_regs.H, divisors[0]);
 
-  // SZ3 = MAC3 SAR ((1-sf)*12)                           ;ScreenZ FIFO 0..+FFFFh
-  PushSZ(s32(z >> 12));
-
-  // MAC0=(((H*20000h/SZ3)+1)/2)*IR1+OFX, SX2=MAC0/10000h ;ScrX FIFO -400h..+3FFh
-  // MAC0=(((H*20000h/SZ3)+1)/2)*IR2+OFY, SY2=MAC0/10000h ;ScrY FIFO -400h..+3FFh
-  const s64 result = static_cast<s64>(ZeroExtend64(UNRDivide(m_regs.H, m_regs.SZ3)));
-  const s64 Sx = s64(result) * s64(m_regs.IR1) + s64(m_regs.OFX);
-  const s64 Sy = s64(result) * s64(m_regs.IR2) + s64(m_regs.OFY);
-  CheckMACOverflow<0>(Sx);
-  CheckMACOverflow<0>(Sy);
-  PushSXY(s32(Sx >> 16), s32(Sy >> 16));
-
-  if (last)
+  for (u32 i = 0; i < num_vertices; i++)
   {
-    // MAC0=(((H*20000h/SZ3)+1)/2)*DQA+DQB, IR0=MAC0/1000h  ;Depth cueing 0..+1000h
-    const s64 Sz = s64(result) * s64(m_regs.DQA) + s64(m_regs.DQB);
-    TruncateAndSetMAC<0>(Sz, 0);
-    TruncateAndSetIR<0>(s32(Sz >> 12), true);
+    // MAC0=(((H*20000h/SZ3)+1)/2)*IR1+OFX, SX2=MAC0/10000h ;ScrX FIFO -400h..+3FFh
+    // MAC0=(((H*20000h/SZ3)+1)/2)*IR2+OFY, SY2=MAC0/10000h ;ScrY FIFO -400h..+3FFh
+    s32 ir_values[3];
+    StoreVector3(ir_values, ir[i]);
+    const s64 result = static_cast<s64>(ZeroExtend64(quotients[i]));
+    const s64 Sx = s64(result) * s64(ir_values[0]) + s64(m_regs.OFX);
+    const s64 Sy = s64(result) * s64(ir_values[1]) + s64(m_regs.OFY);
+    CheckMACOverflow<0>(Sx);
+    CheckMACOverflow<0>(Sy);
+    PushSXY(s32(Sx >> 16), s32(Sy >> 16));
+
+    if (i == (num_vertices - 1))
+    {
+      // MAC0=(((H*20000h/SZ3)+1)/2)*DQA+DQB, IR0=MAC0/1000h  ;Depth cueing 0..+1000h
+      const s64 Sz = s64(result) * s64(m_regs.DQA) + s64(m_regs.DQB);
+      TruncateAndSetMAC<0>(Sz, 0);
+      TruncateAndSetIR<0>(s32(Sz >> 12), true);
+    }
   }
+
+  StoreMACAndIR(m_regs, mac[num_vertices - 1], ir[num_vertices - 1]);
+  m_regs.FLAG.bits |= GetFlagBits(flags);
 }
 
 void Core::Execute_RTPS(Instruction inst)
 {
   m_regs.FLAG.Clear();
-  RTPS(m_regs.V0, inst.GetShift(), inst.lm, true);
+  RTP<1>(inst.GetShift(), inst.lm);
   m_regs.FLAG.UpdateError();
 }
 
 void Core::Execute_RTPT(Instruction inst)
 {
   m_regs.FLAG.Clear();
-
-  const u8 shift = inst.GetShift();
-  const bool lm = inst.lm;
-
-  RTPS(m_regs.V0, shift, lm, false);
-  RTPS(m_regs.V1, shift, lm, false);
-  RTPS(m_regs.V2, shift, lm, true);
-
+  RTP<3>(inst.GetShift(), inst.lm);
   m_regs.FLAG.UpdateError();
 }
 
@@ -656,138 +1134,117 @@ void Core::Execute_AVSZ4(Instruction inst)
   m_regs.FLAG.UpdateError();
 }
 
-void Core::InterpolateColor(s64 in_MAC1, s64 in_MAC2, s64 in_MAC3, u8 shift, bool lm)
+void Core::InterpolateColor(s32 in_MAC1, s32 in_MAC2, s32 in_MAC3, u8 shift, bool lm)
 {
-  // [MAC1,MAC2,MAC3] = MAC+(FC-MAC)*IR0
-  //   [IR1,IR2,IR3] = (([RFC,GFC,BFC] SHL 12) - [MAC1,MAC2,MAC3]) SAR (sf*12)
-  TruncateAndSetMACAndIR<1>((s64(m_regs.FC[0]) << 12) - in_MAC1, shift, false);
-  TruncateAndSetMACAndIR<2>((s64(m_regs.FC[1]) << 12) - in_MAC2, shift, false);
-  TruncateAndSetMACAndIR<3>((s64(m_regs.FC[2]) << 12) - in_MAC3, shift, false);
-
-  //   [MAC1,MAC2,MAC3] = (([IR1,IR2,IR3] * IR0) + [MAC1,MAC2,MAC3])
-  // [MAC1,MAC2,MAC3] = [MAC1,MAC2,MAC3] SAR (sf*12)
-  TruncateAndSetMACAndIR<1>(s64(s32(m_regs.IR1) * s32(m_regs.IR0)) + in_MAC1, shift, lm);
-  TruncateAndSetMACAndIR<2>(s64(s32(m_regs.IR2) * s32(m_regs.IR0)) + in_MAC2, shift, lm);
-  TruncateAndSetMACAndIR<3>(s64(s32(m_regs.IR3) * s32(m_regs.IR0)) + in_MAC3, shift, lm);
+  ComponentFlags flags;
+  Vector3 mac;
+  const MACVector3 fc = ExtendMACShiftLeft12(LoadVector3(m_regs.FC[0], m_regs.FC[1], m_regs.FC[2]));
+  const Vector3 ir = InterpolateColorVector(fc, BroadcastValue(m_regs.IR0), LoadVector3(in_MAC1, in_MAC2, in_MAC3),
+                                            shift, GetIRMinValue(lm), &mac, &flags);
+  StoreMACAndIR(m_regs, mac, ir);
+  m_regs.FLAG.bits |= GetFlagBits(flags);
 }
 
-void Core::NCS(const s16 V[3], u8 shift, bool lm)
+template<u32 num_vertices, bool color, bool depth_cue>
+void Core::NormalColor(u8 shift, bool lm)
 {
-  // [IR1,IR2,IR3] = [MAC1,MAC2,MAC3] = (LLM*V0) SAR (sf*12)
-  MulMatVec(m_regs.LLM, V[0], V[1], V[2], shift, lm);
-
-  // [IR1,IR2,IR3] = [MAC1,MAC2,MAC3] = (BK*1000h + LCM*IR) SAR (sf*12)
-  MulMatVec(m_regs.LCM, m_regs.BK, m_regs.IR1, m_regs.IR2, m_regs.IR3, shift, lm);
+  const Vector3 llm[3] = {LoadMatrixColumn(m_regs.LLM, 0), LoadMatrixColumn(m_regs.LLM, 1),
+                          LoadMatrixColumn(m_regs.LLM, 2)};
+  const Vector3 lcm[3] = {LoadMatrixColumn(m_regs.LCM, 0), LoadMatrixColumn(m_regs.LCM, 1),
+                          LoadMatrixColumn(m_regs.LCM, 2)};
+  const MACVector3 zero = ExtendMAC(LoadVector3(0, 0, 0));
+  const MACVector3 bk = ExtendMACShiftLeft12(LoadVector3(m_regs.BK[0], m_regs.BK[1], m_regs.BK[2]));
+  const MACVector3 fc = ExtendMACShiftLeft12(LoadVector3(m_regs.FC[0], m_regs.FC[1], m_regs.FC[2]));
+  const Vector3 ir0 = BroadcastValue(m_regs.IR0);
+
+  // Pre-shifted, since the product still fits in the 16-bit range.
+  const Vector3 rgb = LoadVector3(ZeroExtend32(m_regs.RGBC[0]) << 4, ZeroExtend32(m_regs.RGBC[1]) << 4,
+                                  ZeroExtend32(m_regs.RGBC[2]) << 4);
+  const Vector3 ir_min_value = GetIRMinValue(lm);
+  ComponentFlags flags;
+
+  // The vertices don't depend on each other, so light them all before writing back any results.
+  Vector3 mac[3];
+  Vector3 ir[3];
+  for (u32 i = 0; i < num_vertices; i++)
+  {
+    // [IR1,IR2,IR3] = [MAC1,MAC2,MAC3] = (LLM*V0) SAR (sf*12)
+    const s16* V = GetVertex(m_regs, i);
+    const MACVector3 light =
+      MulMatVecMAC(llm, zero, BroadcastValue(V[0]), BroadcastValue(V[1]), BroadcastValue(V[2]), &flags);
+    const Vector3 light_ir = SaturateIR(ShiftRightMAC(light, shift), ir_min_value, &flags);
+
+    // [IR1,IR2,IR3] = [MAC1,MAC2,MAC3] = (BK*1000h + LCM*IR) SAR (sf*12)
+    const MACVector3 lit = MulMatVecMAC(lcm, bk, BroadcastComponent<0>(light_ir), BroadcastComponent<1>(light_ir),
+                                        BroadcastComponent<2>(light_ir), &flags);
+    mac[i] = ShiftRightMAC(lit, shift);
+    ir[i] = SaturateIR(mac[i], ir_min_value, &flags);
+
+    if constexpr (color)
+    {
+      // [MAC1,MAC2,MAC3] = [R*IR1,G*IR2,B*IR3] SHL 4          ;<--- for NCDx/NCCx
+      const Vector3 colored = MulS16(rgb, ir[i]);
+      if constexpr (depth_cue)
+      {
+        // [MAC1,MAC2,MAC3] = MAC+(FC-MAC)*IR0                   ;<--- for NCDx only
+        ir[i] = InterpolateColorVector(fc, ir0, colored, shift, ir_min_value, &mac[i], &flags);
+      }
+      else
+      {
+        // [MAC1,MAC2,MAC3] = [MAC1,MAC2,MAC3] SAR (sf*12)       ;<--- for NCDx/NCCx
+        mac[i] = ShiftRightMAC(ExtendMAC(colored), shift);
+        ir[i] = SaturateIR(mac[i], ir_min_value, &flags);
+      }
+    }
+  }
 
   // Color FIFO = [MAC1/16,MAC2/16,MAC3/16,CODE], [IR1,IR2,IR3] = [MAC1,MAC2,MAC3]
-  PushRGBFromMAC();
+  for (u32 i = 0; i < num_vertices; i++)
+    PushRGB(SaturateColor(ShiftRight<4>(mac[i]), &flags));
+
+  StoreMACAndIR(m_regs, mac[num_vertices - 1], ir[num_vertices - 1]);
+  m_regs.FLAG.bits |= GetFlagBits(flags);
 }
 
 void Core::Execute_NCS(Instruction inst)
 {
   m_regs.FLAG.Clear();
-
-  NCS(m_regs.V0, inst.GetShift(), inst.lm);
-
+  NormalColor<1, false, false>(inst.GetShift(), inst.lm);
   m_regs.FLAG.UpdateError();
 }
 
 void Core::Execute_NCT(Instruction inst)
 {
   m_regs.FLAG.Clear();
-
-  const u8 shift = inst.GetShift();
-  const bool lm = inst.lm;
-
-  NCS(m_regs.V0, shift, lm);
-  NCS(m_regs.V1, shift, lm);
-  NCS(m_regs.V2, shift, lm);
-
+  NormalColor<3, false, false>(inst.GetShift(), inst.lm);
   m_regs.FLAG.UpdateError();
 }
 
-void Core::NCCS(const s16 V[3], u8 shift, bool lm)
-{
-  // [IR1,IR2,IR3] = [MAC1,MAC2,MAC3] = (LLM*V0) SAR (sf*12)
-  MulMatVec(m_regs.LLM, V[0], V[1], V[2], shift, lm);
-
-  // [IR1,IR2,IR3] = [MAC1,MAC2,MAC3] = (BK*1000h + LCM*IR) SAR (sf*12)
-  MulMatVec(m_regs.LCM, m_regs.BK, m_regs.IR1, m_regs.IR2, m_regs.IR3, shift, lm);
-
-  // [MAC1,MAC2,MAC3] = [R*IR1,G*IR2,B*IR3] SHL 4          ;<--- for NCDx/NCCx
-  // [MAC1,MAC2,MAC3] = [MAC1,MAC2,MAC3] SAR (sf*12)       ;<--- for NCDx/NCCx
-  TruncateAndSetMACAndIR<1>(s64(s32(ZeroExtend32(m_regs.RGBC[0])) * s32(m_regs.IR1)) << 4, shift, lm);
-  TruncateAndSetMACAndIR<2>(s64(s32(ZeroExtend32(m_regs.RGBC[1])) * s32(m_regs.IR2)) << 4, shift, lm);
-  TruncateAndSetMACAndIR<3>(s64(s32(ZeroExtend32(m_regs.RGBC[2])) * s32(m_regs.IR3)) << 4, shift, lm);
-
-  // Color FIFO = [MAC1/16,MAC2/16,MAC3/16,CODE], [IR1,IR2,IR3] = [MAC1,MAC2,MAC3]
-  PushRGBFromMAC();
-}
-
 void Core::Execute_NCCS(Instruction inst)
 {
   m_regs.FLAG.Clear();
-
-  NCCS(m_regs.V0, inst.GetShift(), inst.lm);
-
+  NormalColor<1, true, false>(inst.GetShift(), inst.lm);
   m_regs.FLAG.UpdateError();
 }
 
 void Core::Execute_NCCT(Instruction inst)
 {
   m_regs.FLAG.Clear();
-
-  const u8 shift = inst.GetShift();
-  const bool lm = inst.lm;
-
-  NCCS(m_regs.V0, shift, lm);
-  NCCS(m_regs.V1, shift, lm);
-  NCCS(m_regs.V2, shift, lm);
-
+  NormalColor<3, true, false>(inst.GetShift(), inst.lm);
   m_regs.FLAG.UpdateError();
 }
 
-void Core::NCDS(const s16 V[3], u8 shift, bool lm)
-{
-  // [IR1,IR2,IR3] = [MAC1,MAC2,MAC3] = (LLM*V0) SAR (sf*12)
-  MulMatVec(m_regs.LLM, V[0], V[1], V[2], shift, lm);
-
-  // [IR1,IR2,IR3] = [MAC1,MAC2,MAC3] = (BK*1000h + LCM*IR) SAR (sf*12)
-  MulMatVec(m_regs.LCM, m_regs.BK, m_regs.IR1, m_regs.IR2, m_regs.IR3, shift, lm);
-
-  // No need to assign these to MAC[1-3], as it'll never overflow.
-  // [MAC1,MAC2,MAC3] = [R*IR1,G*IR2,B*IR3] SHL 4          ;<--- for NCDx/NCCx
-  const s32 in_MAC1 = (s32(ZeroExtend32(m_regs.RGBC[0])) * s32(m_regs.IR1)) << 4;
-  const s32 in_MAC2 = (s32(ZeroExtend32(m_regs.RGBC[1])) * s32(m_regs.IR2)) << 4;
-  const s32 in_MAC3 = (s32(ZeroExtend32(m_regs.RGBC[2])) * s32(m_regs.IR3)) << 4;
-
-  // [MAC1,MAC2,MAC3] = MAC+(FC-MAC)*IR0                   ;<--- for NCDx only
-  InterpolateColor(in_MAC1, in_MAC2, in_MAC3, shift, lm);
-
-  // Color FIFO = [MAC1/16,MAC2/16,MAC3/16,CODE], [IR1,IR2,IR3] = [MAC1,MAC2,MAC3]
-  PushRGBFromMAC();
-}
-
 void Core::Execute_NCDS(Instruction inst)
 {
   m_regs.FLAG.Clear();
-
-  NCDS(m_regs.V0, inst.GetShift(), inst.lm);
-
+  NormalColor<1, true, true>(inst.GetShift(), inst.lm);
   m_regs.FLAG.UpdateError();
 }
 
 void Core::Execute_NCDT(Instruction inst)
 {
   m_regs.FLAG.Clear();
-
-  const u8 shift = inst.GetShift();
-  const bool lm = inst.lm;
-
-  NCDS(m_regs.V0, shift, lm);
-  NCDS(m_regs.V1, shift, lm);
-  NCDS(m_regs.V2, shift, lm);
-
+  NormalColor<3, true, true>(inst.GetShift(), inst.lm);
   m_regs.FLAG.UpdateError();
 }
 
@@ -58,30 +58,32 @@ private:
   template<u32 index>
   void TruncateAndSetIR(s32 value, bool lm);
 
-  template<u32 index>
-  u32 TruncateRGB(s32 value);
-
   void SetOTZ(s32 value);
   void PushSXY(s32 x, s32 y);
   void PushSZ(s32 value);
   void PushRGBFromMAC();
+  void PushRGB(u32 rgb);
 
   // Divide using Unsigned Newton-Raphson algorithm.
   u32 UNRDivide(u32 lhs, u32 rhs);
 
-  // 3x3 matrix * 3x1 vector, updates MAC[1-3] and IR[1-3]
-  void MulMatVec(const s16 M[3][3], const s16 Vx, const s16 Vy, const s16 Vz, u8 shift, bool lm);
+  // Same as UNRDivide, for the three vertices of RTPT.
+  void UNRDivide3(u32 lhs, const u32 rhs[3], u32 results[3]);
 
   // 3x3 matrix * 3x1 vector with translation, updates MAC[1-3] and IR[1-3]
   void MulMatVec(const s16 M[3][3], const s32 T[3], const s16 Vx, const s16 Vy, const s16 Vz, u8 shift, bool lm);
 
   // Interpolate colour, or as in nocash "MAC+(FC-MAC)*IR0".
-  void InterpolateColor(s64 in_MAC1, s64 in_MAC2, s64 in_MAC3, u8 shift, bool lm);
+  void InterpolateColor(s32 in_MAC1, s32 in_MAC2, s32 in_MAC3, u8 shift, bool lm);
+
+  // Transforms and projects V0 (RTPS) or V0-V2 (RTPT).
+  template<u32 num_vertices>
+  void RTP(u8 shift, bool lm);
+
+  // Lights V0 (NCS/NCCS/NCDS) or V0-V2 (NCT/NCCT/NCDT), optionally multiplying by the colour and depth cueing.
+  template<u32 num_vertices, bool color, bool depth_cue>
+  void NormalColor(u8 shift, bool lm);
 
-  void RTPS(const s16 V[3], u8 shift, bool lm, bool last);
-  void NCS(const s16 V[3], u8 shift, bool lm);
-  void NCCS(const s16 V[3], u8 shift, bool lm);
-  void NCDS(const s16 V[3], u8 shift, bool lm);
   void DPCS(const u8 color[3], u8 shift, bool lm);
 
   void Execute_MVMVA(Instruction inst);
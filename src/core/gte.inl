@@ -97,21 +97,3 @@ void GTE::Core::TruncateAndSetMACAndIR(s64 value, u8 shift, bool lm)
   // set IR
   TruncateAndSetIR<index>(value32, lm);
 }
-
-template<u32 index>
-u32 GTE::Core::TruncateRGB(s32 value)
-{
-  if (value < 0 || value > 0xFF)
-  {
-    if constexpr (index == 0)
-      m_regs.FLAG.color_r_saturated = true;
-    else if constexpr (index == 1)
-      m_regs.FLAG.color_g_saturated = true;
-    else
-      m_regs.FLAG.color_b_saturated = true;
-
-    return (value < 0) ? 0 : 0xFF;
-  }
-
-  return static_cast<u32>(value);
-}
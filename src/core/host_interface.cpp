@@ -3,6 +3,7 @@
 #include "cdrom.h"
 #include "common/audio_stream.h"
 #include "common/byte_stream.h"
+#include "common/cd_image.h"
 #include "common/file_system.h"
 #include "common/log.h"
 #include "common/string_util.h"
@@ -14,6 +15,7 @@
 #include "spu.h"
 #include "system.h"
 #include "timers.h"
+#include <algorithm>
 #include <cmath>
 #include <cstring>
 #include <imgui.h>
@@ -51,9 +53,13 @@ HostInterface::HostInterface()
   m_game_list = std::make_unique<GameList>();
   m_game_list->SetCacheFilename(GetGameListCacheFileName());
   m_game_list->SetDatabaseFilename(GetGameListDatabaseFileName());
+  CDImage::SetZipIndexCacheDirectory(GetUserDirectoryRelativePath("cache"));
 }
 
-HostInterface::~HostInterface() = default;
+HostInterface::~HostInterface()
+{
+  StopSaveStateWriteThread();
+}
 
 bool HostInterface::CreateSystem()
 {
@@ -68,6 +74,8 @@ bool HostInterface::CreateSystem()
 
 bool HostInterface::BootSystem(const char* filename, const char* state_filename)
 {
+  ClearRewindStates();
+  InvalidateRunAheadState();
   if (!m_system->Boot(filename))
     return false;
 
@@ -82,12 +90,15 @@ bool HostInterface::BootSystem(const char* filename, const char* state_filename)
 
 void HostInterface::ResetSystem()
 {
+  InvalidateRunAheadState();
   m_system->Reset();
   AddOSDMessage("System reset.");
 }
 
 void HostInterface::DestroySystem()
 {
+  ClearRewindStates();
+  InvalidateRunAheadState();
   m_system.reset();
   m_paused = false;
   UpdateSpeedLimiterState();
@@ -103,6 +114,11 @@ void HostInterface::ReportMessage(const char* message)
   Log_InfoPrintf(message);
 }
 
+void HostInterface::ReportProgress(const char* message, u32 progress_value, u32 progress_max)
+{
+  Log_InfoPrintf("%s: %u/%u", message, progress_value, progress_max);
+}
+
 void HostInterface::ReportFormattedError(const char* format, ...)
 {
   std::va_list ap;
@@ -339,45 +355,507 @@ std::optional<std::vector<u8>> HostInterface::GetBIOSImage(ConsoleRegion region)
   return BIOS::LoadImageFromFile(m_settings.bios_path);
 }
 
+// Save state files start with a header giving the version and compression of the state data which follows. States
+// saved by older versions don't have the header, and are uncompressed version 1 states.
+static constexpr u32 SAVE_STATE_HEADER_MAGIC = 0x43535344; // DSSC
+static constexpr u32 SAVE_STATE_VERSION_NO_HEADER = 1;
+static constexpr int SAVE_STATE_DEFLATE_LEVEL = 1;
+static constexpr int SAVE_STATE_LZMA_LEVEL = 5;
+
+static bool WriteSaveStateHeader(ByteStream* stream, SaveStateCompression compression,
+                                 std::unique_ptr<ByteStream>* compressed_stream)
+{
+  const u32 magic = SAVE_STATE_HEADER_MAGIC;
+  const u32 version = SAVE_STATE_VERSION;
+  const u32 compression_value = static_cast<u32>(compression);
+  if (!stream->Write2(&magic, sizeof(magic)) || !stream->Write2(&version, sizeof(version)) ||
+      !stream->Write2(&compression_value, sizeof(compression_value)))
+  {
+    return false;
+  }
+
+  switch (compression)
+  {
+    case SaveStateCompression::Deflate:
+      *compressed_stream = ByteStream_CreateDeflateCompressStream(stream, SAVE_STATE_DEFLATE_LEVEL);
+      return static_cast<bool>(*compressed_stream);
+
+    case SaveStateCompression::LZMA:
+      *compressed_stream = ByteStream_CreateLZMACompressStream(stream, SAVE_STATE_LZMA_LEVEL);
+      return static_cast<bool>(*compressed_stream);
+
+    default:
+      return true;
+  }
+}
+
+static bool ReadSaveStateHeader(ByteStream* stream, std::unique_ptr<ByteStream>* compressed_stream, u32* version)
+{
+  u32 magic;
+  if (!stream->Read2(&magic, sizeof(magic)))
+    return false;
+
+  if (magic != SAVE_STATE_HEADER_MAGIC)
+  {
+    *version = SAVE_STATE_VERSION_NO_HEADER;
+    return stream->SeekAbsolute(0);
+  }
+
+  if (!stream->Read2(version, sizeof(*version)))
+    return false;
+
+  if (*version > SAVE_STATE_VERSION)
+  {
+    Log_ErrorPrintf("Save state version %u is newer than the supported version %u", *version, SAVE_STATE_VERSION);
+    return false;
+  }
+
+  u32 compression_value;
+  if (!stream->Read2(&compression_value, sizeof(compression_value)))
+    return false;
+
+  switch (static_cast<SaveStateCompression>(compression_value))
+  {
+    case SaveStateCompression::None:
+      return true;
+
+    case SaveStateCompression::Deflate:
+      *compressed_stream = ByteStream_CreateDeflateDecompressStream(stream);
+      return static_cast<bool>(*compressed_stream);
+
+    case SaveStateCompression::LZMA:
+      *compressed_stream = ByteStream_CreateLZMADecompressStream(stream);
+      return static_cast<bool>(*compressed_stream);
+
+    default:
+      Log_ErrorPrintf("Unknown save state compression type %u", compression_value);
+      return false;
+  }
+}
+
+static bool WriteSaveStateFile(const char* filename, SaveStateCompression compression, const void* data, u32 size)
+{
+  std::unique_ptr<ByteStream> stream =
+    FileSystem::OpenFile(filename, BYTESTREAM_OPEN_CREATE | BYTESTREAM_OPEN_WRITE | BYTESTREAM_OPEN_TRUNCATE |
+                                     BYTESTREAM_OPEN_ATOMIC_UPDATE | BYTESTREAM_OPEN_STREAMED);
+  if (!stream)
+    return false;
+
+  // The compressing stream commits the file once the compressed data is complete.
+  std::unique_ptr<ByteStream> compressed_stream;
+  const bool header_written = WriteSaveStateHeader(stream.get(), compression, &compressed_stream);
+  ByteStream* state_stream = compressed_stream ? compressed_stream.get() : stream.get();
+  if (!header_written || !state_stream->Write2(data, size) || !state_stream->Commit())
+  {
+    stream->Discard();
+    return false;
+  }
+
+  return true;
+}
+
 bool HostInterface::LoadState(const char* filename)
 {
+  // Don't read a file which is still being written.
+  WaitForSaveStateWrites();
+
   std::unique_ptr<ByteStream> stream = FileSystem::OpenFile(filename, BYTESTREAM_OPEN_READ | BYTESTREAM_OPEN_STREAMED);
   if (!stream)
     return false;
 
   AddFormattedOSDMessage(2.0f, "Loading state from %s...", filename);
 
-  const bool result = m_system->LoadState(stream.get());
+  InvalidateRunAheadState();
+
+  std::unique_ptr<ByteStream> compressed_stream;
+  u32 version;
+  const bool result =
+    ReadSaveStateHeader(stream.get(), &compressed_stream, &version) &&
+    m_system->LoadState(compressed_stream ? compressed_stream.get() : stream.get(), false, nullptr, version);
   if (!result)
   {
     ReportFormattedError("Loading state from %s failed. Resetting.", filename);
     m_system->Reset();
   }
 
+  m_audio_stream->EmptyBuffers();
   return result;
 }
 
 bool HostInterface::SaveState(const char* filename)
 {
-  std::unique_ptr<ByteStream> stream =
-    FileSystem::OpenFile(filename, BYTESTREAM_OPEN_CREATE | BYTESTREAM_OPEN_WRITE | BYTESTREAM_OPEN_TRUNCATE |
-                                     BYTESTREAM_OPEN_ATOMIC_UPDATE | BYTESTREAM_OPEN_STREAMED);
-  if (!stream)
+  DiscardRunAheadFrames();
+
+  PendingSaveStateWrite write;
+  write.filename = filename;
+  write.state = ByteStream_CreateGrowableMemoryStream();
+  write.compression = m_settings.save_state_compression;
+  if (!m_system->SaveState(write.state.get()))
+  {
+    Log_ErrorPrintf("Saving state to %s failed.", filename);
+    AddFormattedOSDMessage(5.0f, "Saving state to %s failed.", filename);
     return false;
+  }
 
-  const bool result = m_system->SaveState(stream.get());
-  if (!result)
+  std::unique_lock<std::mutex> lock(m_save_state_write_mutex);
+  if (!m_save_state_write_thread.joinable())
+    m_save_state_write_thread = std::thread(&HostInterface::SaveStateWriteThreadEntryPoint, this);
+
+  // WaitForSaveStateWrites() only reports the result of the latest write, earlier failures went to the OSD already.
+  write.serial = ++m_save_state_write_serial;
+  m_save_state_write_failed = false;
+  m_pending_save_state_writes.push_back(std::move(write));
+  m_save_state_write_cv.notify_one();
+  return true;
+}
+
+bool HostInterface::WaitForSaveStateWrites()
+{
+  std::unique_lock<std::mutex> lock(m_save_state_write_mutex);
+  m_save_state_write_done_cv.wait(
+    lock, [this]() { return m_pending_save_state_writes.empty() && !m_save_state_write_busy; });
+
+  return !m_save_state_write_failed;
+}
+
+void HostInterface::StopSaveStateWriteThread()
+{
+  if (!m_save_state_write_thread.joinable())
+    return;
+
+  // Anything still queued is written before the thread exits.
   {
-    ReportFormattedError("Saving state to %s failed.", filename);
-    stream->Discard();
+    std::unique_lock<std::mutex> lock(m_save_state_write_mutex);
+    m_save_state_write_thread_shutdown = true;
+    m_save_state_write_cv.notify_one();
   }
-  else
+
+  m_save_state_write_thread.join();
+}
+
+void HostInterface::SaveStateWriteThreadEntryPoint()
+{
+  std::unique_lock<std::mutex> lock(m_save_state_write_mutex);
+  for (;;)
   {
-    AddFormattedOSDMessage(2.0f, "State saved to %s.", filename);
-    stream->Commit();
+    m_save_state_write_cv.wait(
+      lock, [this]() { return !m_pending_save_state_writes.empty() || m_save_state_write_thread_shutdown; });
+    if (m_pending_save_state_writes.empty())
+      break;
+
+    PendingSaveStateWrite write = std::move(m_pending_save_state_writes.front());
+    m_pending_save_state_writes.pop_front();
+    m_save_state_write_busy = true;
+    lock.unlock();
+
+    const bool result = WriteSaveStateFile(write.filename.c_str(), write.compression,
+                                           write.state->GetMemoryPointer(), write.state->GetMemorySize());
+    if (result)
+    {
+      AddFormattedOSDMessage(2.0f, "State saved to %s.", write.filename.c_str());
+    }
+    else
+    {
+      Log_ErrorPrintf("Saving state to %s failed.", write.filename.c_str());
+      AddFormattedOSDMessage(5.0f, "Saving state to %s failed.", write.filename.c_str());
+    }
+
+    lock.lock();
+    m_save_state_write_busy = false;
+    if (write.serial == m_save_state_write_serial)
+      m_save_state_write_failed = !result;
+    m_save_state_write_done_cv.notify_all();
   }
+}
 
-  return result;
+// Rewind deltas skip unchanged pages entirely, and split changed pages into runs of changed blocks.
+static constexpr u32 REWIND_DELTA_PAGE_SIZE = 4096;
+static constexpr u32 REWIND_DELTA_BLOCK_SIZE = 8;
+
+// Runs separated by fewer unchanged bytes than this are merged, as a separate run costs its header.
+static constexpr u32 REWIND_DELTA_MERGE_DISTANCE = 8;
+
+/// Returns true if the block at offset is the same in both states. Bytes past the end of a state count as zero.
+static bool CompareRewindStateBlock(const u8* old_data, u32 old_size, const u8* new_data, u32 new_size, u32 offset,
+                                    u32 size)
+{
+  if ((offset + size) > new_size)
+    return false;
+
+  if (size == REWIND_DELTA_BLOCK_SIZE)
+  {
+    u64 old_value, new_value;
+    std::memcpy(&old_value, old_data + offset, sizeof(old_value));
+    std::memcpy(&new_value, new_data + offset, sizeof(new_value));
+    return (old_value == new_value);
+  }
+
+  return (std::memcmp(old_data + offset, new_data + offset, size) == 0);
+}
+
+/// Encodes old_data as a delta against new_data. The delta is the old size, followed by runs of offset, length and
+/// the XOR of the two states over that range.
+static void EncodeRewindDelta(const u8* old_data, u32 old_size, const u8* new_data, u32 new_size,
+                              std::vector<u8>* delta)
+{
+  delta->resize(sizeof(old_size));
+  std::memcpy(delta->data(), &old_size, sizeof(old_size));
+
+  auto write_run = [old_data, new_data, new_size, delta](u32 start, u32 end) {
+    const u32 length = end - start;
+    const size_t delta_offset = delta->size();
+    delta->resize(delta_offset + sizeof(start) + sizeof(length) + length);
+
+    u8* out_ptr = delta->data() + delta_offset;
+    std::memcpy(out_ptr, &start, sizeof(start));
+    std::memcpy(out_ptr + sizeof(start), &length, sizeof(length));
+    out_ptr += sizeof(start) + sizeof(length);
+    for (u32 i = start; i < end; i++)
+      *(out_ptr++) = old_data[i] ^ ((i < new_size) ? new_data[i] : 0);
+  };
+
+  u32 run_start = 0;
+  u32 run_end = 0;
+  bool has_run = false;
+  for (u32 page_start = 0; page_start < old_size; page_start += REWIND_DELTA_PAGE_SIZE)
+  {
+    const u32 page_size = std::min(REWIND_DELTA_PAGE_SIZE, old_size - page_start);
+    if (CompareRewindStateBlock(old_data, old_size, new_data, new_size, page_start, page_size))
+      continue;
+
+    const u32 page_end = page_start + page_size;
+    for (u32 offset = page_start; offset < page_end; offset += REWIND_DELTA_BLOCK_SIZE)
+    {
+      const u32 block_end = std::min(offset + REWIND_DELTA_BLOCK_SIZE, page_end);
+      if (CompareRewindStateBlock(old_data, old_size, new_data, new_size, offset, block_end - offset))
+        continue;
+
+      if (has_run && offset <= (run_end + REWIND_DELTA_MERGE_DISTANCE))
+      {
+        run_end = block_end;
+        continue;
+      }
+
+      if (has_run)
+        write_run(run_start, run_end);
+
+      run_start = offset;
+      run_end = block_end;
+      has_run = true;
+    }
+  }
+
+  if (has_run)
+    write_run(run_start, run_end);
+}
+
+/// Applies a delta created by EncodeRewindDelta() to the newer state, turning it into the older state. The data must
+/// already be the size of the older state.
+static void ApplyRewindDelta(const std::vector<u8>& delta, u8* data)
+{
+  const u8* in_ptr = delta.data() + sizeof(u32);
+  const u8* in_end = delta.data() + delta.size();
+  while (in_ptr != in_end)
+  {
+    u32 start, length;
+    std::memcpy(&start, in_ptr, sizeof(start));
+    std::memcpy(&length, in_ptr + sizeof(start), sizeof(length));
+    in_ptr += sizeof(start) + sizeof(length);
+    for (u32 i = 0; i < length; i++)
+      data[start + i] ^= *(in_ptr++);
+  }
+}
+
+/// Reconstructs the older state stream from a delta created by EncodeRewindDelta() and the newer state.
+static std::unique_ptr<GrowableMemoryByteStream> DecodeRewindDelta(const std::vector<u8>& delta, const u8* new_data,
+                                                                   u32 new_size)
+{
+  u32 old_size;
+  std::memcpy(&old_size, delta.data(), sizeof(old_size));
+
+  std::unique_ptr<GrowableMemoryByteStream> stream = ByteStream_CreateGrowableMemoryStream(nullptr, old_size);
+  stream->Write2(new_data, std::min(old_size, new_size), nullptr);
+  for (u32 i = new_size; i < old_size; i++)
+    stream->WriteByte(0);
+
+  ApplyRewindDelta(delta, stream->GetMemoryPointer());
+  stream->SeekAbsolute(0);
+  return stream;
+}
+
+/// Encodes a delta between two copies of a memory region, which are always the same size.
+template<typename T>
+static void EncodeRewindMemoryDelta(const std::vector<T>& old_data, const std::vector<T>& new_data,
+                                    std::vector<u8>* delta)
+{
+  const u32 size = static_cast<u32>(old_data.size() * sizeof(T));
+  EncodeRewindDelta(reinterpret_cast<const u8*>(old_data.data()), size, reinterpret_cast<const u8*>(new_data.data()),
+                    size, delta);
+}
+
+void HostInterface::RunFrame()
+{
+  if (m_rewinding)
+  {
+    StepRewind();
+    return;
+  }
+
+  DiscardRunAheadFrames();
+  m_system->RunFrame();
+
+  if (m_settings.rewind_enable && ++m_rewind_frame_counter >= m_settings.rewind_save_frequency)
+  {
+    m_rewind_frame_counter = 0;
+    SaveRewindState();
+  }
+
+  if (m_settings.run_ahead_frames > 0)
+    RunAhead();
+}
+
+void HostInterface::RunAhead()
+{
+  if (!m_run_ahead_state)
+    m_run_ahead_state = ByteStream_CreateGrowableMemoryStream();
+
+  // The state is about the same size every frame, so the buffer is reused rather than reallocated.
+  m_run_ahead_state->SeekAbsolute(0);
+  if (!m_system->SaveState(m_run_ahead_state.get(), true))
+  {
+    Log_ErrorPrintf("Failed to save run-ahead state, disabling run-ahead.");
+    AddOSDMessage("Failed to save run-ahead state, disabling run-ahead.", 5.0f);
+    m_settings.run_ahead_frames = 0;
+    return;
+  }
+
+  m_run_ahead_state_valid = true;
+
+  // The audio has already been output by the real frame, only the video from the last frame is wanted.
+  m_system->SetRunningAhead(true);
+  for (u32 i = 0; i < m_settings.run_ahead_frames; i++)
+    m_system->RunFrame();
+  m_system->SetRunningAhead(false);
+}
+
+void HostInterface::DiscardRunAheadFrames()
+{
+  if (!m_run_ahead_state_valid)
+    return;
+
+  m_run_ahead_state_valid = false;
+  m_run_ahead_state->SeekAbsolute(0);
+  if (!m_system->LoadState(m_run_ahead_state.get(), true))
+  {
+    ReportError("Loading run-ahead state failed. Resetting.");
+    m_system->Reset();
+  }
+}
+
+void HostInterface::InvalidateRunAheadState()
+{
+  m_run_ahead_state_valid = false;
+}
+
+void HostInterface::SetRewinding(bool rewinding)
+{
+  if (!m_system || m_rewinding == rewinding)
+    return;
+
+  if (rewinding && !m_rewind_state)
+  {
+    AddOSDMessage(m_settings.rewind_enable ? "No rewind states saved yet." : "Rewind is not enabled.");
+    return;
+  }
+
+  // Rewind states are full states, so there's nothing to go back to once one has been loaded.
+  InvalidateRunAheadState();
+
+  m_rewinding = rewinding;
+  m_rewind_frame_counter = 0;
+  if (!rewinding)
+    m_system->ResetPerformanceCounters();
+}
+
+void HostInterface::SaveRewindState()
+{
+  Common::Timer timer;
+
+  const u32 size_hint = m_rewind_state ? m_rewind_state->GetMemorySize() : 0;
+  std::unique_ptr<GrowableMemoryByteStream> stream = ByteStream_CreateGrowableMemoryStream(nullptr, size_hint);
+  std::unique_ptr<SystemMemorySnapshot> memory = std::make_unique<SystemMemorySnapshot>();
+  if (!m_system->SaveState(stream.get(), false, memory.get()))
+  {
+    Log_ErrorPrintf("Failed to save rewind state, disabling rewind.");
+    AddOSDMessage("Failed to save rewind state, disabling rewind.", 5.0f);
+    m_settings.rewind_enable = false;
+    ClearRewindStates();
+    return;
+  }
+
+  // Saving includes reading back VRAM from the hardware renderers, which is usually the most expensive part.
+  const double save_time = timer.GetTimeMilliseconds();
+
+  u32 delta_size = 0;
+  if (m_rewind_state)
+  {
+    RewindDelta delta;
+    EncodeRewindDelta(m_rewind_state->GetMemoryPointer(), m_rewind_state->GetMemorySize(),
+                      stream->GetMemoryPointer(), stream->GetMemorySize(), &delta.state);
+    EncodeRewindMemoryDelta(m_rewind_memory->ram, memory->ram, &delta.ram);
+    EncodeRewindMemoryDelta(m_rewind_memory->vram, memory->vram, &delta.vram);
+    EncodeRewindMemoryDelta(m_rewind_memory->spu_ram, memory->spu_ram, &delta.spu_ram);
+    delta_size = static_cast<u32>(delta.state.size() + delta.ram.size() + delta.vram.size() + delta.spu_ram.size());
+    m_rewind_deltas.push_back(std::move(delta));
+
+    // The oldest state only has to be dropped, as nothing is stored relative to it.
+    while (m_rewind_deltas.size() >= m_settings.rewind_save_slots)
+      m_rewind_deltas.pop_front();
+  }
+
+  m_rewind_state = std::move(stream);
+  m_rewind_memory = std::move(memory);
+  Log_DevPrintf("Saved rewind state (%u bytes, delta %u bytes) in %.2f ms, %.2f ms of which saving",
+                m_rewind_state->GetMemorySize(), delta_size, timer.GetTimeMilliseconds(), save_time);
+}
+
+void HostInterface::StepRewind()
+{
+  // Rewinds at twice the speed the states were saved at.
+  if (++m_rewind_frame_counter < std::max(m_settings.rewind_save_frequency / 2, 1u))
+    return;
+  m_rewind_frame_counter = 0;
+
+  if (!m_rewind_deltas.empty())
+  {
+    const RewindDelta& delta = m_rewind_deltas.back();
+    m_rewind_state =
+      DecodeRewindDelta(delta.state, m_rewind_state->GetMemoryPointer(), m_rewind_state->GetMemorySize());
+    ApplyRewindDelta(delta.ram, m_rewind_memory->ram.data());
+    ApplyRewindDelta(delta.vram, reinterpret_cast<u8*>(m_rewind_memory->vram.data()));
+    ApplyRewindDelta(delta.spu_ram, m_rewind_memory->spu_ram.data());
+    m_rewind_deltas.pop_back();
+  }
+
+  m_rewind_state->SeekAbsolute(0);
+  if (!m_system->LoadState(m_rewind_state.get(), false, m_rewind_memory.get()))
+  {
+    ReportError("Loading rewind state failed. Resetting.");
+    m_system->Reset();
+    m_rewinding = false;
+    ClearRewindStates();
+  }
+
+  m_audio_stream->EmptyBuffers();
+}
+
+void HostInterface::ClearRewindStates()
+{
+  m_rewind_state.reset();
+  m_rewind_memory.reset();
+  m_rewind_deltas.clear();
+  m_rewind_frame_counter = 0;
+  m_rewinding = false;
 }
 
 void HostInterface::UpdateSpeedLimiterState()
@@ -393,6 +871,9 @@ void HostInterface::UpdateSpeedLimiterState()
   if (audio_sync_enabled)
     m_audio_stream->EmptyBuffers();
 
+  // Rate control only makes sense when running at normal speed, otherwise we'd just be dropping frames anyway.
+  m_audio_stream->SetDynamicRateControl(m_speed_limiter_enabled && m_settings.audio_dynamic_rate_control);
+
   m_display->SetVSync(video_sync_enabled);
   if (m_system)
     m_system->ResetPerformanceCounters();
@@ -505,6 +986,11 @@ void HostInterface::SetDefaultSettings()
 
   m_settings.speed_limiter_enabled = true;
   m_settings.start_paused = false;
+  m_settings.save_state_compression = SaveStateCompression::Deflate;
+  m_settings.rewind_enable = false;
+  m_settings.rewind_save_frequency = 10;
+  m_settings.rewind_save_slots = 60;
+  m_settings.run_ahead_frames = 0;
 
   m_settings.gpu_renderer = GPURenderer::HardwareOpenGL;
   m_settings.gpu_resolution_scale = 1;
@@ -518,6 +1004,13 @@ void HostInterface::SetDefaultSettings()
 
   m_settings.audio_backend = AudioBackend::Default;
   m_settings.audio_sync_enabled = true;
+  m_settings.audio_dynamic_rate_control = false;
+
+  m_settings.cdrom_chd_hunk_cache_size = 16;
+  m_settings.cdrom_load_image_to_ram = false;
+  m_settings.cdrom_read_speedup = 1;
+
+  m_settings.mdec_use_worker_thread = true;
 
   m_settings.bios_path = GetUserDirectoryRelativePath("bios/scph1001.bin");
   m_settings.bios_patch_tty_enable = false;
@@ -540,15 +1033,23 @@ void HostInterface::UpdateSettings(const std::function<void()>& apply_callback)
   const bool old_gpu_force_progressive_scan = m_settings.gpu_force_progressive_scan;
   const bool old_vsync_enabled = m_settings.video_sync_enabled;
   const bool old_audio_sync_enabled = m_settings.audio_sync_enabled;
+  const bool old_audio_dynamic_rate_control = m_settings.audio_dynamic_rate_control;
   const bool old_speed_limiter_enabled = m_settings.speed_limiter_enabled;
   const bool old_display_linear_filtering = m_settings.display_linear_filtering;
+  const u32 old_cdrom_read_speedup = m_settings.cdrom_read_speedup;
+
+  DiscardRunAheadFrames();
 
   apply_callback();
 
+  if (!m_settings.rewind_enable)
+    ClearRewindStates();
+
   if (m_settings.gpu_renderer != old_gpu_renderer)
     SwitchGPURenderer();
 
   if (m_settings.video_sync_enabled != old_vsync_enabled || m_settings.audio_sync_enabled != old_audio_sync_enabled ||
+      m_settings.audio_dynamic_rate_control != old_audio_dynamic_rate_control ||
       m_settings.speed_limiter_enabled != old_speed_limiter_enabled)
   {
     UpdateSpeedLimiterState();
@@ -566,6 +1067,9 @@ void HostInterface::UpdateSettings(const std::function<void()>& apply_callback)
     {
       m_system->UpdateGPUSettings();
     }
+
+    if (m_settings.cdrom_read_speedup != old_cdrom_read_speedup)
+      m_system->GetCDROM()->UpdateReadSpeed();
   }
 
   if (m_settings.display_linear_filtering != old_display_linear_filtering)
@@ -581,6 +1085,7 @@ void HostInterface::ToggleSoftwareRendering()
     m_system->GetGPU()->IsHardwareRenderer() ? GPURenderer::Software : m_settings.gpu_renderer;
 
   AddFormattedOSDMessage(2.0f, "Switching to %s renderer...", Settings::GetRendererDisplayName(new_renderer));
+  DiscardRunAheadFrames();
   m_system->RecreateGPU(new_renderer);
 }
 
@@ -3,20 +3,24 @@
 #include "settings.h"
 #include "types.h"
 #include <chrono>
+#include <condition_variable>
 #include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
+#include <thread>
 #include <vector>
 
 class AudioStream;
 class CDImage;
+class GrowableMemoryByteStream;
 class HostDisplay;
 class GameList;
 
 class System;
+struct SystemMemorySnapshot;
 
 class HostInterface
 {
@@ -49,6 +53,9 @@ public:
   void ReportFormattedError(const char* format, ...);
   void ReportFormattedMessage(const char* format, ...);
 
+  /// Reports the progress of a long-running operation, e.g. preloading the disc image.
+  virtual void ReportProgress(const char* message, u32 progress_value, u32 progress_max);
+
   /// Adds OSD messages, duration is in seconds.
   void AddOSDMessage(const char* message, float duration = 2.0f);
   void AddFormattedOSDMessage(float duration, const char* format, ...);
@@ -57,8 +64,25 @@ public:
   virtual std::optional<std::vector<u8>> GetBIOSImage(ConsoleRegion region);
 
   bool LoadState(const char* filename);
+
+  /// Captures the state immediately, then compresses and writes it to the file on a background thread. Returns false
+  /// if the state could not be captured, write failures are reported through the OSD.
   bool SaveState(const char* filename);
 
+  /// Waits for any save states still being written. Returns false if the most recently saved state failed to write.
+  bool WaitForSaveStateWrites();
+
+  /// Runs the system for a frame, or steps back through the rewind buffer while rewinding. With run-ahead, the
+  /// system is left the configured number of frames ahead of the real frame, so that frame is displayed.
+  void RunFrame();
+
+  /// Returns the system to the last real frame, discarding the frames which were run ahead. Call before changing
+  /// anything in the system from outside of RunFrame(), or it would be lost when the real frame is restored.
+  void DiscardRunAheadFrames();
+
+  /// While rewinding, the system steps backwards through the saved rewind states instead of running.
+  void SetRewinding(bool rewinding);
+
   /// Returns the base user directory path.
   const std::string& GetUserDirectory() const { return m_user_directory; }
 
@@ -81,6 +105,14 @@ protected:
     float duration;
   };
 
+  struct PendingSaveStateWrite
+  {
+    std::string filename;
+    std::unique_ptr<GrowableMemoryByteStream> state;
+    SaveStateCompression compression;
+    u32 serial;
+  };
+
   virtual void SwitchGPURenderer();
   virtual void OnSystemPerformanceCountersUpdated();
   virtual void OnRunningGameChanged();
@@ -126,6 +158,16 @@ protected:
 
   void UpdateSpeedLimiterState();
 
+  void StopSaveStateWriteThread();
+  void SaveStateWriteThreadEntryPoint();
+
+  void SaveRewindState();
+  void StepRewind();
+  void ClearRewindStates();
+
+  void RunAhead();
+  void InvalidateRunAheadState();
+
   void DrawFPSWindow();
   void DrawOSDMessages();
   void DrawDebugWindows();
@@ -144,4 +186,36 @@ protected:
 
   std::deque<OSDMessage> m_osd_messages;
   std::mutex m_osd_messages_lock;
+
+  std::thread m_save_state_write_thread;
+  std::mutex m_save_state_write_mutex;
+  std::condition_variable m_save_state_write_cv;
+  std::condition_variable m_save_state_write_done_cv;
+  std::deque<PendingSaveStateWrite> m_pending_save_state_writes;
+  u32 m_save_state_write_serial = 0;
+  bool m_save_state_write_busy = false;
+  bool m_save_state_write_failed = false;
+  bool m_save_state_write_thread_shutdown = false;
+
+  // Older rewind states are stored as the difference from the state after them. The large memory regions are diffed
+  // separately, so that changes in the size of the rest of the state don't shift them.
+  struct RewindDelta
+  {
+    std::vector<u8> state;
+    std::vector<u8> ram;
+    std::vector<u8> vram;
+    std::vector<u8> spu_ram;
+  };
+
+  // The newest rewind state is kept whole.
+  std::unique_ptr<GrowableMemoryByteStream> m_rewind_state;
+  std::unique_ptr<SystemMemorySnapshot> m_rewind_memory;
+  std::deque<RewindDelta> m_rewind_deltas;
+  u32 m_rewind_frame_counter = 0;
+  bool m_rewinding = false;
+
+  // State of the last real frame while running ahead. VRAM is kept in the GPU's backup, so this can't be used for
+  // anything else.
+  std::unique_ptr<GrowableMemoryByteStream> m_run_ahead_state;
+  bool m_run_ahead_state_valid = false;
 };
@@ -1,15 +1,27 @@
 #include "mdec.h"
+#include "common/cpu_detect.h"
 #include "common/log.h"
 #include "common/state_wrapper.h"
 #include "dma.h"
 #include "interrupt_controller.h"
 #include "system.h"
 #include <imgui.h>
+#if defined(CPU_X64)
+#include <emmintrin.h>
+#elif defined(CPU_AARCH64)
+#include <arm_neon.h>
+#endif
 Log_SetChannel(MDEC);
 
+// Set to true to use the direct matrix product from the nocash spec, as a reference for the vectorized IDCT.
+static constexpr bool USE_REFERENCE_IDCT = false;
+
 MDEC::MDEC() = default;
 
-MDEC::~MDEC() = default;
+MDEC::~MDEC()
+{
+  StopWorkerThread();
+}
 
 void MDEC::Initialize(System* system, DMA* dma)
 {
@@ -26,6 +38,8 @@ void MDEC::Reset()
 
 bool MDEC::DoState(StateWrapper& sw)
 {
+  WaitForBlockConversion();
+
   sw.Do(&m_status.bits);
   sw.Do(&m_enable_dma_in);
   sw.Do(&m_enable_dma_out);
@@ -40,7 +54,14 @@ bool MDEC::DoState(StateWrapper& sw)
   sw.Do(&m_current_block);
   sw.Do(&m_current_coefficient);
   sw.Do(&m_current_q_scale);
-  sw.Do(&m_block_rgb);
+  if (sw.GetVersion() >= 2)
+    sw.Do(&m_num_transformed_blocks);
+  else if (sw.IsReading())
+    m_num_transformed_blocks = m_current_block;
+
+  sw.Do(&m_block_output);
+  if (sw.IsReading() && sw.GetVersion() < 2)
+    ConvertLegacyBlockOutput();
 
   bool block_copy_out_pending = HasPendingBlockCopyOut();
   sw.Do(&block_copy_out_pending);
@@ -143,6 +164,8 @@ bool MDEC::HasPendingBlockCopyOut() const
 
 void MDEC::SoftReset()
 {
+  WaitForBlockConversion();
+
   m_status.bits = 0;
   m_enable_dma_in = false;
   m_enable_dma_out = false;
@@ -153,6 +176,7 @@ void MDEC::SoftReset()
   m_current_block = 0;
   m_current_coefficient = 64;
   m_current_q_scale = 0;
+  m_num_transformed_blocks = 0;
   m_block_copy_out_event->Deactivate();
   UpdateStatus();
 }
@@ -330,6 +354,7 @@ void MDEC::EndCommand()
   m_current_block = 0;
   m_current_coefficient = 64;
   m_current_q_scale = 0;
+  m_num_transformed_blocks = 0;
   UpdateStatus();
 }
 
@@ -358,10 +383,7 @@ bool MDEC::DecodeMonoMacroblock()
   if (!rl_decode_block(m_blocks[0].data(), m_iq_y.data()))
     return false;
 
-  IDCT(m_blocks[0].data());
-
-  y_to_mono(m_blocks[0]);
-
+  StartBlockConversion();
   ScheduleBlockCopyOut(TICKS_PER_BLOCK);
 
   m_total_blocks_decoded++;
@@ -386,19 +408,13 @@ bool MDEC::DecodeColoredMacroblock()
   {
     if (!rl_decode_block(m_blocks[m_current_block].data(), (m_current_block >= 2) ? m_iq_y.data() : m_iq_uv.data()))
       return false;
-
-    IDCT(m_blocks[m_current_block].data());
   }
 
   // done decoding
   m_current_block = 0;
   Log_DebugPrintf("Decoded colored macroblock, %u words remaining", m_remaining_halfwords / 2);
 
-  yuv_to_rgb(0, 0, m_blocks[0], m_blocks[1], m_blocks[2]);
-  yuv_to_rgb(8, 0, m_blocks[0], m_blocks[1], m_blocks[3]);
-  yuv_to_rgb(0, 8, m_blocks[0], m_blocks[1], m_blocks[4]);
-  yuv_to_rgb(8, 8, m_blocks[0], m_blocks[1], m_blocks[5]);
-
+  StartBlockConversion();
   ScheduleBlockCopyOut(TICKS_PER_BLOCK);
 
   m_total_blocks_decoded += 4;
@@ -420,110 +436,106 @@ void MDEC::CopyOutBlock()
 
   Log_DebugPrintf("Copying out block");
 
-  switch (m_status.data_output_depth)
+  // The block was converted to the output format when it was decoded, though the worker thread may still be busy.
+  WaitForBlockConversion();
+  m_data_out_fifo.PushRange(m_block_output.data(), GetBlockOutputWordCount());
+
+  // if we've copied out all blocks, command is complete
+  if (m_remaining_halfwords == 0)
+    EndCommand();
+  else
+    ExecutePendingCommand();
+}
+
+void MDEC::StartBlockConversion()
+{
+  m_conversion_status.bits = m_status.bits;
+  m_conversion_num_transformed_blocks = m_num_transformed_blocks;
+  m_num_transformed_blocks = 0;
+
+  if (!m_system->GetSettings().mdec_use_worker_thread)
   {
-    case DataOutputDepth_4Bit:
-    {
-      const u32* in_ptr = m_block_rgb.data();
-      for (u32 i = 0; i < (64 / 8); i++)
-      {
-        u32 value = *(in_ptr++) >> 4;
-        value |= (*(in_ptr++) >> 4) << 4;
-        value |= (*(in_ptr++) >> 4) << 8;
-        value |= (*(in_ptr++) >> 4) << 12;
-        value |= (*(in_ptr++) >> 4) << 16;
-        value |= (*(in_ptr++) >> 4) << 20;
-        value |= (*(in_ptr++) >> 4) << 24;
-        value |= (*(in_ptr++) >> 4) << 28;
-        m_data_out_fifo.Push(value);
-      }
-    }
-    break;
+    StopWorkerThread();
+    ConvertBlocks();
+    return;
+  }
 
-    case DataOutputDepth_8Bit:
-    {
-      const u32* in_ptr = m_block_rgb.data();
-      for (u32 i = 0; i < (64 / 4); i++)
-      {
-        u32 value = *in_ptr++;
-        value |= *in_ptr++ << 8;
-        value |= *in_ptr++ << 16;
-        value |= *in_ptr++ << 24;
-        m_data_out_fifo.Push(value);
-      }
-    }
-    break;
+  if (!m_worker_thread.joinable())
+    StartWorkerThread();
 
-    case DataOutputDepth_24Bit:
-    {
-      // pack tightly
-      u32 index = 0;
-      u32 state = 0;
-      u32 rgb = 0;
-      while (index < m_block_rgb.size())
-      {
-        switch (state)
-        {
-          case 0:
-            rgb = m_block_rgb[index++]; // RGB-
-            state = 1;
-            break;
-          case 1:
-            rgb |= (m_block_rgb[index] & 0xFF) << 24; // RGBR
-            m_data_out_fifo.Push(rgb);
-            rgb = m_block_rgb[index] >> 8; // GB--
-            index++;
-            state = 2;
-            break;
-          case 2:
-            rgb |= m_block_rgb[index] << 16; // GBRG
-            m_data_out_fifo.Push(rgb);
-            rgb = m_block_rgb[index] >> 16; // B---
-            index++;
-            state = 3;
-            break;
-          case 3:
-            rgb |= m_block_rgb[index] << 8; // BRGB
-            m_data_out_fifo.Push(rgb);
-            index++;
-            state = 0;
-            break;
-        }
-      }
-      break;
-    }
+  std::unique_lock<std::mutex> lock(m_worker_mutex);
+  DebugAssert(!m_worker_conversion_pending);
+  m_worker_conversion_pending = true;
+  m_worker_cv.notify_one();
+}
 
-    case DataOutputDepth_15Bit:
-    {
-      const u16 a = ZeroExtend16(m_status.data_output_bit15.GetValue());
-      for (u32 i = 0; i < static_cast<u32>(m_block_rgb.size());)
-      {
-        u32 color = m_block_rgb[i++];
-        u16 r = Truncate16((color >> 3) & 0x1Fu);
-        u16 g = Truncate16((color >> 11) & 0x1Fu);
-        u16 b = Truncate16((color >> 19) & 0x1Fu);
-        const u16 color15a = r | (g << 5) | (b << 10) | (a << 15);
-
-        color = m_block_rgb[i++];
-        r = Truncate16((color >> 3) & 0x1Fu);
-        g = Truncate16((color >> 11) & 0x1Fu);
-        b = Truncate16((color >> 19) & 0x1Fu);
-        const u16 color15b = r | (g << 5) | (b << 10) | (a << 15);
-
-        m_data_out_fifo.Push(ZeroExtend32(color15a) | (ZeroExtend32(color15b) << 16));
-      }
-    }
-    break;
+void MDEC::WaitForBlockConversion()
+{
+  if (!m_worker_thread.joinable())
+    return;
 
-    default:
-      break;
-  }
+  std::unique_lock<std::mutex> lock(m_worker_mutex);
+  if (!m_worker_conversion_pending)
+    return;
 
-  // if we've copied out all blocks, command is complete
-  if (m_remaining_halfwords == 0)
-    EndCommand();
+  Log_DevPrint("MDEC worker thread is behind - waiting");
+  m_worker_wait_count++;
+  m_worker_done_cv.wait(lock, [this]() { return !m_worker_conversion_pending; });
+}
+
+void MDEC::ConvertBlocks()
+{
+  if (m_conversion_status.data_output_depth <= DataOutputDepth_8Bit)
+  {
+    IDCT(m_blocks[0].data());
+    PackMonoBlock();
+  }
   else
-    ExecutePendingCommand();
+  {
+    for (u32 i = m_conversion_num_transformed_blocks; i < NUM_BLOCKS; i++)
+      IDCT(m_blocks[i].data());
+
+    PackColoredMacroblock();
+  }
+}
+
+void MDEC::StartWorkerThread()
+{
+  DebugAssert(!m_worker_thread.joinable());
+  m_worker_shutdown = false;
+  m_worker_thread = std::thread(&MDEC::WorkerThreadEntryPoint, this);
+}
+
+void MDEC::StopWorkerThread()
+{
+  if (!m_worker_thread.joinable())
+    return;
+
+  {
+    std::unique_lock<std::mutex> lock(m_worker_mutex);
+    m_worker_shutdown = true;
+    m_worker_cv.notify_one();
+  }
+
+  m_worker_thread.join();
+}
+
+void MDEC::WorkerThreadEntryPoint()
+{
+  std::unique_lock<std::mutex> lock(m_worker_mutex);
+  for (;;)
+  {
+    m_worker_cv.wait(lock, [this]() { return m_worker_conversion_pending || m_worker_shutdown; });
+    if (!m_worker_conversion_pending)
+      break;
+
+    lock.unlock();
+    ConvertBlocks();
+    lock.lock();
+
+    m_worker_conversion_pending = false;
+    m_worker_done_cv.notify_one();
+  }
 }
 
 static constexpr std::array<u8, 64> zigzag = {{0,  1,  5,  6,  14, 15, 27, 28, 2,  4,  7,  13, 16, 26, 29, 42,
@@ -604,6 +616,143 @@ bool MDEC::rl_decode_block(s16* blk, const u8* qt)
 }
 
 void MDEC::IDCT(s16* blk)
+{
+  if constexpr (USE_REFERENCE_IDCT)
+  {
+    IDCT_Reference(blk);
+    return;
+  }
+
+  // Both passes multiply each row by the scale table. Coefficients are clamped to 11 bits by rl_decode_block(), so the
+  // first pass fits in 32 bits, but the second pass needs up to 44 bits before rounding.
+#if defined(CPU_X64)
+  // Rows are interleaved in pairs, so that _mm_madd_epi16() can multiply and sum two rows at once.
+  __m128i blk_pairs[4][2];
+  __m128i scale_pairs[4][2];
+  for (u32 k = 0; k < 4; k++)
+  {
+    const __m128i blk0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&blk[k * 16]));
+    const __m128i blk1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&blk[k * 16 + 8]));
+    blk_pairs[k][0] = _mm_unpacklo_epi16(blk0, blk1);
+    blk_pairs[k][1] = _mm_unpackhi_epi16(blk0, blk1);
+
+    const __m128i scale0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&m_scale_table[k * 16]));
+    const __m128i scale1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&m_scale_table[k * 16 + 8]));
+    scale_pairs[k][0] = _mm_unpacklo_epi16(scale0, scale1);
+    scale_pairs[k][1] = _mm_unpackhi_epi16(scale0, scale1);
+  }
+
+  // The first pass results are split into the bits above and below bit 14, so both halves fit in 16-bit lanes.
+  const __m128i low_mask = _mm_set1_epi32(0x3FFF);
+  __m128i temp_high[8];
+  __m128i temp_low[8];
+  for (u32 y = 0; y < 8; y++)
+  {
+    __m128i sum0 = _mm_setzero_si128();
+    __m128i sum1 = _mm_setzero_si128();
+    for (u32 k = 0; k < 4; k++)
+    {
+      const u32 scale_pair = ZeroExtend32(static_cast<u16>(m_scale_table[k * 16 + y])) |
+                             (ZeroExtend32(static_cast<u16>(m_scale_table[k * 16 + 8 + y])) << 16);
+      const __m128i scale = _mm_set1_epi32(static_cast<int>(scale_pair));
+      sum0 = _mm_add_epi32(sum0, _mm_madd_epi16(scale, blk_pairs[k][0]));
+      sum1 = _mm_add_epi32(sum1, _mm_madd_epi16(scale, blk_pairs[k][1]));
+    }
+
+    temp_high[y] = _mm_packs_epi32(_mm_srai_epi32(sum0, 14), _mm_srai_epi32(sum1, 14));
+    temp_low[y] = _mm_packs_epi32(_mm_and_si128(sum0, low_mask), _mm_and_si128(sum1, low_mask));
+  }
+
+  // The result is rounded to bit 32 and then truncated to 9 bits, so only bits 31-40 of the sum matter. The high half
+  // products are only needed modulo 2^32, but the low half sums are kept exact so their carry is correct.
+  const __m128i round = _mm_set1_epi32(1 << 17);
+  for (u32 y = 0; y < 8; y++)
+  {
+    const __m128i high0 = _mm_shuffle_epi32(temp_high[y], _MM_SHUFFLE(0, 0, 0, 0));
+    const __m128i high1 = _mm_shuffle_epi32(temp_high[y], _MM_SHUFFLE(1, 1, 1, 1));
+    const __m128i high2 = _mm_shuffle_epi32(temp_high[y], _MM_SHUFFLE(2, 2, 2, 2));
+    const __m128i high3 = _mm_shuffle_epi32(temp_high[y], _MM_SHUFFLE(3, 3, 3, 3));
+    const __m128i low0 = _mm_shuffle_epi32(temp_low[y], _MM_SHUFFLE(0, 0, 0, 0));
+    const __m128i low1 = _mm_shuffle_epi32(temp_low[y], _MM_SHUFFLE(1, 1, 1, 1));
+    const __m128i low2 = _mm_shuffle_epi32(temp_low[y], _MM_SHUFFLE(2, 2, 2, 2));
+    const __m128i low3 = _mm_shuffle_epi32(temp_low[y], _MM_SHUFFLE(3, 3, 3, 3));
+
+    __m128i result[2];
+    for (u32 half = 0; half < 2; half++)
+    {
+      const __m128i high_sum0 =
+        _mm_add_epi32(_mm_madd_epi16(high0, scale_pairs[0][half]), _mm_madd_epi16(high1, scale_pairs[1][half]));
+      const __m128i high_sum1 =
+        _mm_add_epi32(_mm_madd_epi16(high2, scale_pairs[2][half]), _mm_madd_epi16(high3, scale_pairs[3][half]));
+      const __m128i high_sum = _mm_add_epi32(high_sum0, high_sum1);
+      const __m128i low_sum0 =
+        _mm_add_epi32(_mm_madd_epi16(low0, scale_pairs[0][half]), _mm_madd_epi16(low1, scale_pairs[1][half]));
+      const __m128i low_sum1 =
+        _mm_add_epi32(_mm_madd_epi16(low2, scale_pairs[2][half]), _mm_madd_epi16(low3, scale_pairs[3][half]));
+
+      // (high_sum << 14) + low_sum0 + low_sum1 + (1 << 31), shifted right by 14.
+      const __m128i low_carry = _mm_srai_epi32(
+        _mm_add_epi32(_mm_and_si128(low_sum0, low_mask), _mm_and_si128(low_sum1, low_mask)), 14);
+      __m128i sum = _mm_add_epi32(high_sum, _mm_add_epi32(_mm_srai_epi32(low_sum0, 14), _mm_srai_epi32(low_sum1, 14)));
+      sum = _mm_add_epi32(_mm_add_epi32(sum, low_carry), round);
+
+      // Take bits 32-40 of the rounded sum, sign-extended.
+      result[half] = _mm_srai_epi32(_mm_slli_epi32(sum, 5), 23);
+    }
+
+    const __m128i row = _mm_packs_epi32(result[0], result[1]);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&blk[y * 8]),
+                     _mm_min_epi16(_mm_max_epi16(row, _mm_set1_epi16(-128)), _mm_set1_epi16(127)));
+  }
+#elif defined(CPU_AARCH64)
+  std::array<s32, 64> temp;
+  for (u32 y = 0; y < 8; y++)
+  {
+    int32x4_t sum0 = vdupq_n_s32(0);
+    int32x4_t sum1 = vdupq_n_s32(0);
+    for (u32 u = 0; u < 8; u++)
+    {
+      const int16x8_t row = vld1q_s16(&blk[u * 8]);
+      const s16 scale = m_scale_table[u * 8 + y];
+      sum0 = vmlal_n_s16(sum0, vget_low_s16(row), scale);
+      sum1 = vmlal_n_s16(sum1, vget_high_s16(row), scale);
+    }
+
+    vst1q_s32(&temp[y * 8], sum0);
+    vst1q_s32(&temp[y * 8 + 4], sum1);
+  }
+
+  for (u32 y = 0; y < 8; y++)
+  {
+    int64x2_t sum0 = vdupq_n_s64(0);
+    int64x2_t sum1 = vdupq_n_s64(0);
+    int64x2_t sum2 = vdupq_n_s64(0);
+    int64x2_t sum3 = vdupq_n_s64(0);
+    for (u32 u = 0; u < 8; u++)
+    {
+      const int16x8_t scale = vld1q_s16(&m_scale_table[u * 8]);
+      const int32x4_t scale0 = vmovl_s16(vget_low_s16(scale));
+      const int32x4_t scale1 = vmovl_s16(vget_high_s16(scale));
+      const s32 value = temp[y * 8 + u];
+      sum0 = vmlal_n_s32(sum0, vget_low_s32(scale0), value);
+      sum1 = vmlal_n_s32(sum1, vget_high_s32(scale0), value);
+      sum2 = vmlal_n_s32(sum2, vget_low_s32(scale1), value);
+      sum3 = vmlal_n_s32(sum3, vget_high_s32(scale1), value);
+    }
+
+    // The rounding shift matches (sum >> 32) + ((sum >> 31) & 1). Then sign-extend from 9 bits.
+    const int32x4_t result0 = vcombine_s32(vmovn_s64(vrshrq_n_s64(sum0, 32)), vmovn_s64(vrshrq_n_s64(sum1, 32)));
+    const int32x4_t result1 = vcombine_s32(vmovn_s64(vrshrq_n_s64(sum2, 32)), vmovn_s64(vrshrq_n_s64(sum3, 32)));
+    const int16x8_t row = vcombine_s16(vmovn_s32(vshrq_n_s32(vshlq_n_s32(result0, 23), 23)),
+                                       vmovn_s32(vshrq_n_s32(vshlq_n_s32(result1, 23), 23)));
+    vst1q_s16(&blk[y * 8], vminq_s16(vmaxq_s16(row, vdupq_n_s16(-128)), vdupq_n_s16(127)));
+  }
+#else
+  IDCT_Reference(blk);
+#endif
+}
+
+void MDEC::IDCT_Reference(s16* blk)
 {
   std::array<s64, 64> temp_buffer;
   for (u32 x = 0; x < 8; x++)
@@ -630,46 +779,287 @@ void MDEC::IDCT(s16* blk)
   }
 }
 
-void MDEC::yuv_to_rgb(u32 xx, u32 yy, const std::array<s16, 64>& Crblk, const std::array<s16, 64>& Cbblk,
-                      const std::array<s16, 64>& Yblk)
+void MDEC::ConvertLegacyBlockOutput()
 {
-  for (u32 y = 0; y < 8; y++)
+  // Older states hold the block as one 00BBGGRR value (or mono value) per pixel, which was packed on copy-out.
+  const std::array<u32, 256> pixels = m_block_output;
+  const u16 bit15 = ZeroExtend16(m_status.data_output_bit15.GetValue()) << 15;
+  u8* out_bytes = reinterpret_cast<u8*>(m_block_output.data());
+  m_block_output.fill(0);
+
+  switch (m_status.data_output_depth)
   {
-    for (u32 x = 0; x < 8; x++)
+    case DataOutputDepth_4Bit:
+    {
+      for (u32 i = 0; i < 64; i++)
+        m_block_output[i / 8] |= ((pixels[i] & 0xFFu) >> 4) << ((i % 8) * 4);
+    }
+    break;
+
+    case DataOutputDepth_8Bit:
+    {
+      for (u32 i = 0; i < 64; i++)
+        out_bytes[i] = Truncate8(pixels[i]);
+    }
+    break;
+
+    case DataOutputDepth_24Bit:
+    {
+      for (u32 i = 0; i < 256; i++)
+      {
+        out_bytes[i * 3 + 0] = Truncate8(pixels[i]);
+        out_bytes[i * 3 + 1] = Truncate8(pixels[i] >> 8);
+        out_bytes[i * 3 + 2] = Truncate8(pixels[i] >> 16);
+      }
+    }
+    break;
+
+    case DataOutputDepth_15Bit:
+    default:
     {
-      s16 R = Crblk[((x + xx) / 2) + ((y + yy) / 2) * 8];
-      s16 B = Cbblk[((x + xx) / 2) + ((y + yy) / 2) * 8];
-      s16 G = static_cast<s16>((-0.3437f * static_cast<float>(B)) + (-0.7143f * static_cast<float>(R)));
-
-      R = static_cast<s16>(1.402f * static_cast<float>(R));
-      B = static_cast<s16>(1.772f * static_cast<float>(B));
-
-      s16 Y = Yblk[x + y * 8];
-      R = static_cast<s16>(std::clamp(static_cast<int>(Y) + R, -128, 127));
-      G = static_cast<s16>(std::clamp(static_cast<int>(Y) + G, -128, 127));
-      B = static_cast<s16>(std::clamp(static_cast<int>(Y) + B, -128, 127));
-
-      // TODO: Signed output
-      R += 128;
-      G += 128;
-      B += 128;
-
-      m_block_rgb[(x + xx) + ((y + yy) * 16)] = ZeroExtend32(static_cast<u16>(R)) |
-                                                (ZeroExtend32(static_cast<u16>(G)) << 8) |
-                                                (ZeroExtend32(static_cast<u16>(B)) << 16);
+      for (u32 i = 0; i < 256; i++)
+      {
+        const u32 color = pixels[i];
+        const u16 color15 =
+          Truncate16(((color >> 3) & 0x1Fu) | (((color >> 11) & 0x1Fu) << 5) | (((color >> 19) & 0x1Fu) << 10) | bit15);
+        std::memcpy(&out_bytes[i * 2], &color15, sizeof(color15));
+      }
     }
+    break;
   }
 }
 
-void MDEC::y_to_mono(const std::array<s16, 64>& Yblk)
+u32 MDEC::GetBlockOutputWordCount() const
 {
+  switch (m_status.data_output_depth)
+  {
+    case DataOutputDepth_4Bit:
+      return 64 / 8;
+    case DataOutputDepth_8Bit:
+      return 64 / 4;
+    case DataOutputDepth_24Bit:
+      return (256 * 3) / 4;
+    case DataOutputDepth_15Bit:
+    default:
+      return 256 / 2;
+  }
+}
+
+#if defined(CPU_X64)
+
+static ALWAYS_INLINE __m128i ClampToS8(__m128i value)
+{
+  return _mm_min_epi16(_mm_max_epi16(value, _mm_set1_epi16(-128)), _mm_set1_epi16(127));
+}
+
+static ALWAYS_INLINE __m128i ConvertChroma(__m128 value, float scale)
+{
+  // Truncates like the static_cast<s16> in the nocash spec.
+  return _mm_cvttps_epi32(_mm_mul_ps(value, _mm_set1_ps(scale)));
+}
+
+static ALWAYS_INLINE __m128i PackRGB24(__m128i rgb)
+{
+  // Four 00BBGGRR words to twelve tightly-packed bytes, first in each 64-bit half, then across the halves.
+  const __m128i pairs = _mm_or_si128(_mm_and_si128(rgb, _mm_set_epi32(0, 0xFFFFFF, 0, 0xFFFFFF)),
+                                     _mm_slli_epi64(_mm_srli_epi64(rgb, 32), 24));
+  return _mm_or_si128(_mm_and_si128(pairs, _mm_set_epi32(0, 0, 0xFFFF, -1)),
+                      _mm_and_si128(_mm_srli_si128(pairs, 2), _mm_set_epi32(0, -1, static_cast<int>(0xFFFF0000), 0)));
+}
+
+#endif
+
+void MDEC::PackColoredMacroblock()
+{
+  // Each chroma sample is shared by a 2x2 group of pixels, so convert it once.
+  const std::array<s16, 64>& Crblk = m_blocks[0];
+  const std::array<s16, 64>& Cbblk = m_blocks[1];
+  alignas(16) std::array<s16, 64> r_offsets;
+  alignas(16) std::array<s16, 64> g_offsets;
+  alignas(16) std::array<s16, 64> b_offsets;
+#if defined(CPU_X64)
+  for (u32 i = 0; i < 64; i += 4)
+  {
+    const __m128i cr16 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&Crblk[i]));
+    const __m128i cb16 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&Cbblk[i]));
+    const __m128 cr = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(cr16, cr16), 16));
+    const __m128 cb = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(cb16, cb16), 16));
+    const __m128 g = _mm_add_ps(_mm_mul_ps(cb, _mm_set1_ps(-0.3437f)), _mm_mul_ps(cr, _mm_set1_ps(-0.7143f)));
+
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(&r_offsets[i]),
+                     _mm_packs_epi32(ConvertChroma(cr, 1.402f), _mm_setzero_si128()));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(&g_offsets[i]),
+                     _mm_packs_epi32(_mm_cvttps_epi32(g), _mm_setzero_si128()));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(&b_offsets[i]),
+                     _mm_packs_epi32(ConvertChroma(cb, 1.772f), _mm_setzero_si128()));
+  }
+#else
   for (u32 i = 0; i < 64; i++)
   {
-    s16 Y = Yblk[i];
-    Y = SignExtendN<10, s16>(Y);
-    Y = std::clamp<s16>(Y, -128, 127);
-    Y += 128;
-    m_block_rgb[i] = static_cast<u32>(Y) & 0xFF;
+    const float R = static_cast<float>(Crblk[i]);
+    const float B = static_cast<float>(Cbblk[i]);
+    g_offsets[i] = static_cast<s16>((-0.3437f * B) + (-0.7143f * R));
+    r_offsets[i] = static_cast<s16>(1.402f * R);
+    b_offsets[i] = static_cast<s16>(1.772f * B);
+  }
+#endif
+
+  // TODO: Signed output
+  const s16 bias = 128;
+  const u16 bit15 = ZeroExtend16(m_conversion_status.data_output_bit15.GetValue()) << 15;
+  const bool output_24bit = (m_conversion_status.data_output_depth == DataOutputDepth_24Bit);
+  u8* out_bytes = reinterpret_cast<u8*>(m_block_output.data());
+
+  // Work a row of 16 pixels at a time, from the left and right luma blocks.
+  for (u32 y = 0; y < 16; y++)
+  {
+    const s16* Yblk_left = &m_blocks[2 + (y / 8) * 2][(y % 8) * 8];
+    const s16* Yblk_right = &m_blocks[3 + (y / 8) * 2][(y % 8) * 8];
+    const u32 chroma_row = (y / 2) * 8;
+
+#if defined(CPU_X64)
+    const __m128i luma[2] = {_mm_loadu_si128(reinterpret_cast<const __m128i*>(Yblk_left)),
+                             _mm_loadu_si128(reinterpret_cast<const __m128i*>(Yblk_right))};
+    const __m128i r_row = _mm_load_si128(reinterpret_cast<const __m128i*>(&r_offsets[chroma_row]));
+    const __m128i g_row = _mm_load_si128(reinterpret_cast<const __m128i*>(&g_offsets[chroma_row]));
+    const __m128i b_row = _mm_load_si128(reinterpret_cast<const __m128i*>(&b_offsets[chroma_row]));
+    const __m128i r_chroma[2] = {_mm_unpacklo_epi16(r_row, r_row), _mm_unpackhi_epi16(r_row, r_row)};
+    const __m128i g_chroma[2] = {_mm_unpacklo_epi16(g_row, g_row), _mm_unpackhi_epi16(g_row, g_row)};
+    const __m128i b_chroma[2] = {_mm_unpacklo_epi16(b_row, b_row), _mm_unpackhi_epi16(b_row, b_row)};
+    const __m128i bias_vec = _mm_set1_epi16(bias);
+    const __m128i byte_mask = _mm_set1_epi16(0xFF);
+
+    for (u32 half = 0; half < 2; half++)
+    {
+      const __m128i r = _mm_and_si128(_mm_add_epi16(ClampToS8(_mm_add_epi16(luma[half], r_chroma[half])), bias_vec),
+                                      byte_mask);
+      const __m128i g = _mm_and_si128(_mm_add_epi16(ClampToS8(_mm_add_epi16(luma[half], g_chroma[half])), bias_vec),
+                                      byte_mask);
+      const __m128i b = _mm_and_si128(_mm_add_epi16(ClampToS8(_mm_add_epi16(luma[half], b_chroma[half])), bias_vec),
+                                      byte_mask);
+
+      const u32 pixel = y * 16 + half * 8;
+      if (output_24bit)
+      {
+        // Each store writes four bytes past the pixels, which are overwritten by the next.
+        const __m128i rg = _mm_or_si128(r, _mm_slli_epi16(g, 8));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&out_bytes[pixel * 3]), PackRGB24(_mm_unpacklo_epi16(rg, b)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&out_bytes[pixel * 3 + 12]),
+                         PackRGB24(_mm_unpackhi_epi16(rg, b)));
+      }
+      else
+      {
+        const __m128i color15 =
+          _mm_or_si128(_mm_or_si128(_mm_srli_epi16(r, 3), _mm_slli_epi16(_mm_srli_epi16(g, 3), 5)),
+                       _mm_or_si128(_mm_slli_epi16(_mm_srli_epi16(b, 3), 10), _mm_set1_epi16(static_cast<s16>(bit15))));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&out_bytes[pixel * 2]), color15);
+      }
+    }
+#elif defined(CPU_AARCH64)
+    const int16x8_t luma[2] = {vld1q_s16(Yblk_left), vld1q_s16(Yblk_right)};
+    const int16x8x2_t r_chroma = vzipq_s16(vld1q_s16(&r_offsets[chroma_row]), vld1q_s16(&r_offsets[chroma_row]));
+    const int16x8x2_t g_chroma = vzipq_s16(vld1q_s16(&g_offsets[chroma_row]), vld1q_s16(&g_offsets[chroma_row]));
+    const int16x8x2_t b_chroma = vzipq_s16(vld1q_s16(&b_offsets[chroma_row]), vld1q_s16(&b_offsets[chroma_row]));
+    const int16x8_t min_value = vdupq_n_s16(-128);
+    const int16x8_t max_value = vdupq_n_s16(127);
+    const int16x8_t bias_vec = vdupq_n_s16(bias);
+
+    for (u32 half = 0; half < 2; half++)
+    {
+      // Narrowing keeps the low byte, same as masking.
+      const uint8x8_t r = vmovn_u16(vreinterpretq_u16_s16(
+        vaddq_s16(vminq_s16(vmaxq_s16(vaddq_s16(luma[half], r_chroma.val[half]), min_value), max_value), bias_vec)));
+      const uint8x8_t g = vmovn_u16(vreinterpretq_u16_s16(
+        vaddq_s16(vminq_s16(vmaxq_s16(vaddq_s16(luma[half], g_chroma.val[half]), min_value), max_value), bias_vec)));
+      const uint8x8_t b = vmovn_u16(vreinterpretq_u16_s16(
+        vaddq_s16(vminq_s16(vmaxq_s16(vaddq_s16(luma[half], b_chroma.val[half]), min_value), max_value), bias_vec)));
+
+      const u32 pixel = y * 16 + half * 8;
+      if (output_24bit)
+      {
+        uint8x8x3_t rgb;
+        rgb.val[0] = r;
+        rgb.val[1] = g;
+        rgb.val[2] = b;
+        vst3_u8(&out_bytes[pixel * 3], rgb);
+      }
+      else
+      {
+        const uint16x8_t color15 =
+          vorrq_u16(vorrq_u16(vshrq_n_u16(vmovl_u8(r), 3), vshlq_n_u16(vshrq_n_u16(vmovl_u8(g), 3), 5)),
+                    vorrq_u16(vshlq_n_u16(vshrq_n_u16(vmovl_u8(b), 3), 10), vdupq_n_u16(bit15)));
+        vst1q_u16(reinterpret_cast<u16*>(&out_bytes[pixel * 2]), color15);
+      }
+    }
+#else
+    for (u32 x = 0; x < 16; x++)
+    {
+      const s16 Y = (x < 8) ? Yblk_left[x] : Yblk_right[x - 8];
+      const u8 R = Truncate8(std::clamp(static_cast<int>(Y) + r_offsets[chroma_row + x / 2], -128, 127) + bias);
+      const u8 G = Truncate8(std::clamp(static_cast<int>(Y) + g_offsets[chroma_row + x / 2], -128, 127) + bias);
+      const u8 B = Truncate8(std::clamp(static_cast<int>(Y) + b_offsets[chroma_row + x / 2], -128, 127) + bias);
+
+      const u32 pixel = y * 16 + x;
+      if (output_24bit)
+      {
+        out_bytes[pixel * 3 + 0] = R;
+        out_bytes[pixel * 3 + 1] = G;
+        out_bytes[pixel * 3 + 2] = B;
+      }
+      else
+      {
+        const u16 color15 = (R >> 3) | ((G >> 3) << 5) | ((B >> 3) << 10) | bit15;
+        std::memcpy(&out_bytes[pixel * 2], &color15, sizeof(color15));
+      }
+    }
+#endif
+  }
+}
+
+void MDEC::PackMonoBlock()
+{
+  const std::array<s16, 64>& Yblk = m_blocks[0];
+  // TODO: Signed output
+  const s16 bias = 128;
+
+  // Y is clamped, then converted the same way as colour.
+  alignas(16) std::array<u8, 64> pixels;
+#if defined(CPU_X64)
+  for (u32 i = 0; i < 64; i += 16)
+  {
+    const __m128i y0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Yblk[i]));
+    const __m128i y1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Yblk[i + 8]));
+    const __m128i p0 = _mm_add_epi16(ClampToS8(y0), _mm_set1_epi16(bias));
+    const __m128i p1 = _mm_add_epi16(ClampToS8(y1), _mm_set1_epi16(bias));
+    const __m128i byte_mask = _mm_set1_epi16(0xFF);
+    _mm_store_si128(reinterpret_cast<__m128i*>(&pixels[i]),
+                    _mm_packus_epi16(_mm_and_si128(p0, byte_mask), _mm_and_si128(p1, byte_mask)));
+  }
+#elif defined(CPU_AARCH64)
+  for (u32 i = 0; i < 64; i += 8)
+  {
+    const int16x8_t y = vld1q_s16(&Yblk[i]);
+    const int16x8_t p = vaddq_s16(vminq_s16(vmaxq_s16(y, vdupq_n_s16(-128)), vdupq_n_s16(127)), vdupq_n_s16(bias));
+    vst1_u8(&pixels[i], vmovn_u16(vreinterpretq_u16_s16(p)));
+  }
+#else
+  for (u32 i = 0; i < 64; i++)
+    pixels[i] = Truncate8(std::clamp<s16>(Yblk[i], -128, 127) + bias);
+#endif
+
+  if (m_conversion_status.data_output_depth == DataOutputDepth_4Bit)
+  {
+    for (u32 i = 0; i < (64 / 8); i++)
+    {
+      u32 value = 0;
+      for (u32 j = 0; j < 8; j++)
+        value |= ZeroExtend32(pixels[i * 8 + j] >> 4) << (j * 4);
+      m_block_output[i] = value;
+    }
+  }
+  else
+  {
+    std::memcpy(m_block_output.data(), pixels.data(), pixels.size());
   }
 }
 
@@ -717,6 +1107,7 @@ void MDEC::DrawDebugStateWindow()
   static constexpr std::array<const char*, 6> block_names = {{"Crblk", "Cbblk", "Y1", "Y2", "Y3", "Y4"}};
 
   ImGui::Text("Blocks Decoded: %u", m_total_blocks_decoded);
+  ImGui::Text("Worker Thread: %s (%u waits)", m_worker_thread.joinable() ? "Running" : "Stopped", m_worker_wait_count);
   ImGui::Text("Data-In FIFO Size: %u (%u bytes)", m_data_in_fifo.GetSize(), m_data_in_fifo.GetSize() * 4);
   ImGui::Text("Data-Out FIFO Size: %u (%u bytes)", m_data_out_fifo.GetSize(), m_data_out_fifo.GetSize() * 4);
   ImGui::Text("DMA Enable: %s%s", m_enable_dma_in ? "In " : "", m_enable_dma_out ? "Out" : "");
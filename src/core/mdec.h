@@ -3,7 +3,10 @@
 #include "common/fifo_queue.h"
 #include "types.h"
 #include <array>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 class StateWrapper;
 
@@ -107,12 +110,28 @@ private:
   void ScheduleBlockCopyOut(TickCount ticks);
   void CopyOutBlock();
 
+  // Runs the IDCT and output conversion for the run-length decoded blocks, on the worker thread if it is enabled.
+  // The blocks and output must not be accessed until WaitForBlockConversion() has returned.
+  void StartBlockConversion();
+  void WaitForBlockConversion();
+  void ConvertBlocks();
+
+  void StartWorkerThread();
+  void StopWorkerThread();
+  void WorkerThreadEntryPoint();
+
+  // Converts the decoded blocks to the output depth, packed as they are read from the data out FIFO.
+  u32 GetBlockOutputWordCount() const;
+  void PackColoredMacroblock();
+  void PackMonoBlock();
+
+  // Packs a block loaded from a version 1 state, which stored one RGB value per pixel.
+  void ConvertLegacyBlockOutput();
+
   // from nocash spec
   bool rl_decode_block(s16* blk, const u8* qt);
   void IDCT(s16* blk);
-  void yuv_to_rgb(u32 xx, u32 yy, const std::array<s16, 64>& Crblk, const std::array<s16, 64>& Cbblk,
-                  const std::array<s16, 64>& Yblk);
-  void y_to_mono(const std::array<s16, 64>& Yblk);
+  void IDCT_Reference(s16* blk);
 
   System* m_system = nullptr;
   DMA* m_dma = nullptr;
@@ -138,8 +157,25 @@ private:
   u32 m_current_coefficient = 64; // k (in block)
   u16 m_current_q_scale = 0;
 
-  std::array<u32, 256> m_block_rgb{};
+  // Number of blocks at the start of m_blocks which already had the IDCT applied. Only non-zero after loading a
+  // version 1 state part way through a macroblock, since the IDCT used to be run as each block was decoded.
+  u32 m_num_transformed_blocks = 0;
+
+  // Packed output for the current block, with space for the 16 byte stores of 24-bit packing.
+  std::array<u32, 256> m_block_output{};
   std::unique_ptr<TimingEvent> m_block_copy_out_event;
 
+  // Output format of the blocks being converted, since the status register keeps changing on the CPU thread.
+  StatusRegister m_conversion_status = {};
+  u32 m_conversion_num_transformed_blocks = 0;
+
+  std::thread m_worker_thread;
+  std::mutex m_worker_mutex;
+  std::condition_variable m_worker_cv;
+  std::condition_variable m_worker_done_cv;
+  bool m_worker_conversion_pending = false;
+  bool m_worker_shutdown = false;
+
   u32 m_total_blocks_decoded = 0;
+  u32 m_worker_wait_count = 0;
 };
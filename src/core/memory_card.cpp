@@ -157,7 +157,10 @@ bool MemoryCard::Transfer(const u8 data_in, u8* data_out)
         if (m_changed)
         {
           m_changed = false;
-          SaveToFile();
+
+          // Frames run ahead are rolled back, the write is saved when the real frame repeats it.
+          if (!m_system->IsRunningAhead())
+            SaveToFile();
         }
       }
     }
@@ -1,4 +1,8 @@
 #pragma once
-#include "pse/types.h"
+#include "types.h"
 
-constexpr u32 SAVE_STATE_VERSION = 1;
+// Bump when the layout or meaning of the state data changes, so older states can be converted when loaded.
+// 1: Original format.
+// 2: The pending MDEC block is stored in the output format, rather than as one RGB value per pixel. The IDCT is run
+//    when the macroblock is complete, so the blocks of a partly decoded macroblock are stored untransformed.
+constexpr u32 SAVE_STATE_VERSION = 2;
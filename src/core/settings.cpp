@@ -1,5 +1,6 @@
 #include "settings.h"
 #include "common/string_util.h"
+#include <algorithm>
 #include <array>
 
 Settings::Settings() = default;
@@ -11,6 +12,16 @@ void Settings::Load(SettingsInterface& si)
 
   speed_limiter_enabled = si.GetBoolValue("General", "SpeedLimiterEnabled", true);
   start_paused = si.GetBoolValue("General", "StartPaused", false);
+  save_state_compression =
+    ParseSaveStateCompression(si.GetStringValue("General", "SaveStateCompression", "Deflate").c_str())
+      .value_or(SaveStateCompression::Deflate);
+  rewind_enable = si.GetBoolValue("General", "RewindEnable", false);
+  rewind_save_frequency = std::min(static_cast<u32>(std::max(si.GetIntValue("General", "RewindFrequency", 10), 1)),
+                                   MAX_REWIND_SAVE_FREQUENCY);
+  rewind_save_slots =
+    std::min(static_cast<u32>(std::max(si.GetIntValue("General", "RewindSaveSlots", 60), 1)), MAX_REWIND_SAVE_SLOTS);
+  run_ahead_frames =
+    std::min(static_cast<u32>(std::max(si.GetIntValue("General", "RunAheadFrames", 0), 0)), MAX_RUN_AHEAD_FRAMES);
 
   cpu_execution_mode = ParseCPUExecutionMode(si.GetStringValue("CPU", "ExecutionMode", "Interpreter").c_str())
                          .value_or(CPUExecutionMode::Interpreter);
@@ -30,6 +41,15 @@ void Settings::Load(SettingsInterface& si)
   audio_backend =
     ParseAudioBackend(si.GetStringValue("Audio", "Backend", "Default").c_str()).value_or(AudioBackend::Default);
   audio_sync_enabled = si.GetBoolValue("Audio", "Sync", true);
+  audio_dynamic_rate_control = si.GetBoolValue("Audio", "DynamicRateControl", false);
+
+  cdrom_chd_hunk_cache_size = std::min(static_cast<u32>(std::max(si.GetIntValue("CDROM", "CHDHunkCacheSize", 16), 1)),
+                                       MAX_CDROM_CHD_HUNK_CACHE_SIZE);
+  cdrom_load_image_to_ram = si.GetBoolValue("CDROM", "LoadImageToRAM", false);
+  cdrom_read_speedup =
+    std::min(static_cast<u32>(std::max(si.GetIntValue("CDROM", "ReadSpeedup", 1), 0)), MAX_CDROM_READ_SPEEDUP);
+
+  mdec_use_worker_thread = si.GetBoolValue("MDEC", "UseWorkerThread", true);
 
   bios_path = si.GetStringValue("BIOS", "Path", "scph1001.bin");
   bios_patch_tty_enable = si.GetBoolValue("BIOS", "PatchTTYEnable", true);
@@ -59,6 +79,11 @@ void Settings::Save(SettingsInterface& si) const
 
   si.SetBoolValue("General", "SpeedLimiterEnabled", speed_limiter_enabled);
   si.SetBoolValue("General", "StartPaused", start_paused);
+  si.SetStringValue("General", "SaveStateCompression", GetSaveStateCompressionName(save_state_compression));
+  si.SetBoolValue("General", "RewindEnable", rewind_enable);
+  si.SetIntValue("General", "RewindFrequency", static_cast<int>(rewind_save_frequency));
+  si.SetIntValue("General", "RewindSaveSlots", static_cast<int>(rewind_save_slots));
+  si.SetIntValue("General", "RunAheadFrames", static_cast<int>(run_ahead_frames));
 
   si.SetStringValue("CPU", "ExecutionMode", GetCPUExecutionModeName(cpu_execution_mode));
 
@@ -75,6 +100,13 @@ void Settings::Save(SettingsInterface& si) const
 
   si.SetStringValue("Audio", "Backend", GetAudioBackendName(audio_backend));
   si.SetBoolValue("Audio", "Sync", audio_sync_enabled);
+  si.SetBoolValue("Audio", "DynamicRateControl", audio_dynamic_rate_control);
+
+  si.SetIntValue("CDROM", "CHDHunkCacheSize", static_cast<long>(cdrom_chd_hunk_cache_size));
+  si.SetBoolValue("CDROM", "LoadImageToRAM", cdrom_load_image_to_ram);
+  si.SetIntValue("CDROM", "ReadSpeedup", static_cast<long>(cdrom_read_speedup));
+
+  si.SetBoolValue("MDEC", "UseWorkerThread", mdec_use_worker_thread);
 
   si.SetStringValue("BIOS", "Path", bios_path.c_str());
   si.SetBoolValue("BIOS", "PatchTTYEnable", bios_patch_tty_enable);
@@ -228,6 +260,51 @@ const char* Settings::GetAudioBackendDisplayName(AudioBackend backend)
   return s_audio_backend_display_names[static_cast<int>(backend)];
 }
 
+static std::array<const char*, 3> s_save_state_compression_names = {{"None", "Deflate", "LZMA"}};
+static std::array<const char*, 3> s_save_state_compression_display_names = {
+  {"None", "Deflate (Fast)", "LZMA (Smallest)"}};
+
+std::optional<SaveStateCompression> Settings::ParseSaveStateCompression(const char* str)
+{
+  int index = 0;
+  for (const char* name : s_save_state_compression_names)
+  {
+    if (StringUtil::Strcasecmp(name, str) == 0)
+      return static_cast<SaveStateCompression>(index);
+
+    index++;
+  }
+
+  return std::nullopt;
+}
+
+const char* Settings::GetSaveStateCompressionName(SaveStateCompression compression)
+{
+  return s_save_state_compression_names[static_cast<int>(compression)];
+}
+
+const char* Settings::GetSaveStateCompressionDisplayName(SaveStateCompression compression)
+{
+  return s_save_state_compression_display_names[static_cast<int>(compression)];
+}
+
+static std::array<const char*, Settings::MAX_CDROM_READ_SPEEDUP + 1> s_cdrom_read_speedup_display_names = {
+  {"Maximum (Paced by Game)", "None (Double Speed)", "2x (Quad Speed)", "3x (6x Speed)", "4x (8x Speed)",
+   "5x (10x Speed)", "6x (12x Speed)", "7x (14x Speed)", "8x (16x Speed)", "9x (18x Speed)", "10x (20x Speed)"}};
+
+const char* Settings::GetCDROMReadSpeedupDisplayName(u32 speedup)
+{
+  return s_cdrom_read_speedup_display_names[std::min(speedup, MAX_CDROM_READ_SPEEDUP)];
+}
+
+static std::array<const char*, Settings::MAX_RUN_AHEAD_FRAMES + 1> s_run_ahead_frames_display_names = {
+  {"Disabled", "1 Frame", "2 Frames", "3 Frames", "4 Frames"}};
+
+const char* Settings::GetRunAheadFramesDisplayName(u32 frames)
+{
+  return s_run_ahead_frames_display_names[std::min(frames, MAX_RUN_AHEAD_FRAMES)];
+}
+
 static std::array<const char*, 3> s_controller_type_names = {{"None", "DigitalController", "AnalogController"}};
 static std::array<const char*, 3> s_controller_display_names = {
   {"None", "Digital Controller", "Analog Controller (DualShock)"}};
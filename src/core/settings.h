@@ -38,6 +38,16 @@ struct Settings
   bool start_paused = false;
   bool speed_limiter_enabled = true;
 
+  SaveStateCompression save_state_compression = SaveStateCompression::Deflate;
+
+  // Rewind keeps a snapshot every rewind_save_frequency frames, up to rewind_save_slots of them.
+  bool rewind_enable = false;
+  u32 rewind_save_frequency = 10;
+  u32 rewind_save_slots = 60;
+
+  // Number of frames to run ahead of the displayed frame to hide the game's input lag, 0 disables.
+  u32 run_ahead_frames = 0;
+
   GPURenderer gpu_renderer = GPURenderer::Software;
   u32 gpu_resolution_scale = 1;
   mutable u32 max_gpu_resolution_scale = 1;
@@ -51,6 +61,16 @@ struct Settings
 
   AudioBackend audio_backend = AudioBackend::Default;
   bool audio_sync_enabled = true;
+  bool audio_dynamic_rate_control = false;
+
+  u32 cdrom_chd_hunk_cache_size = 16;
+  bool cdrom_load_image_to_ram = false;
+
+  // Multiplier for data read and seek speed, 1 = real speed, 0 = as fast as the game acknowledges sectors.
+  u32 cdrom_read_speedup = 1;
+
+  // Runs the MDEC's IDCT and colour conversion on a separate thread. Doesn't affect emulated timing.
+  bool mdec_use_worker_thread = true;
 
   struct DebugSettings
   {
@@ -94,6 +114,21 @@ struct Settings
   static const char* GetAudioBackendName(AudioBackend backend);
   static const char* GetAudioBackendDisplayName(AudioBackend backend);
 
+  static std::optional<SaveStateCompression> ParseSaveStateCompression(const char* str);
+  static const char* GetSaveStateCompressionName(SaveStateCompression compression);
+  static const char* GetSaveStateCompressionDisplayName(SaveStateCompression compression);
+
+  static constexpr u32 MAX_CDROM_CHD_HUNK_CACHE_SIZE = 256;
+
+  static constexpr u32 MAX_CDROM_READ_SPEEDUP = 10;
+  static const char* GetCDROMReadSpeedupDisplayName(u32 speedup);
+
+  static constexpr u32 MAX_REWIND_SAVE_FREQUENCY = 60;
+  static constexpr u32 MAX_REWIND_SAVE_SLOTS = 1000;
+
+  static constexpr u32 MAX_RUN_AHEAD_FRAMES = 4;
+  static const char* GetRunAheadFramesDisplayName(u32 frames);
+
   static std::optional<ControllerType> ParseControllerTypeName(const char* str);
   static const char* GetControllerTypeName(ControllerType type);
   static const char* GetControllerTypeDisplayName(ControllerType type);
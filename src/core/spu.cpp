@@ -1,12 +1,19 @@
 #include "spu.h"
 #include "common/audio_stream.h"
+#include "common/cpu_detect.h"
 #include "common/log.h"
 #include "common/state_wrapper.h"
 #include "dma.h"
 #include "host_interface.h"
 #include "interrupt_controller.h"
 #include "system.h"
+#include <algorithm>
 #include <imgui.h>
+#if defined(CPU_X64)
+#include <emmintrin.h>
+#elif defined(CPU_AARCH64)
+#include <arm_neon.h>
+#endif
 Log_SetChannel(SPU);
 
 // TODO:
@@ -66,11 +73,15 @@ void SPU::Reset()
     v.has_samples = false;
   }
 
+  m_voice_amplitudes.fill(0);
+  m_voice_volumes_left.fill(0);
+  m_voice_volumes_right.fill(0);
   m_ram.fill(0);
+  InvalidateDecodedBlockCache();
   UpdateEventInterval();
 }
 
-bool SPU::DoState(StateWrapper& sw)
+bool SPU::DoState(StateWrapper& sw, std::vector<u8>* ram_copy)
 {
   sw.Do(&m_SPUCNT.bits);
   sw.Do(&m_SPUSTAT.bits);
@@ -99,7 +110,7 @@ bool SPU::DoState(StateWrapper& sw)
     sw.Do(&v.current_block_samples);
     sw.Do(&v.previous_block_last_samples);
     sw.Do(&v.adpcm_last_samples);
-    sw.Do(&v.last_amplitude);
+    sw.Do(&m_voice_amplitudes[i]);
     sw.Do(&v.adsr_phase);
     sw.DoPOD(&v.adsr_target);
     sw.Do(&v.adsr_ticks);
@@ -108,11 +119,25 @@ bool SPU::DoState(StateWrapper& sw)
     sw.Do(&v.has_samples);
   }
 
-  sw.DoBytes(m_ram.data(), RAM_SIZE);
+  if (!ram_copy)
+  {
+    sw.DoBytes(m_ram.data(), RAM_SIZE);
+  }
+  else if (sw.IsReading())
+  {
+    if (ram_copy->size() != RAM_SIZE)
+      return false;
+
+    std::copy(ram_copy->begin(), ram_copy->end(), m_ram.begin());
+  }
+  else
+  {
+    ram_copy->assign(m_ram.begin(), m_ram.end());
+  }
 
   if (sw.IsReading())
   {
-    m_system->GetHostInterface()->GetAudioStream()->EmptyBuffers();
+    InvalidateDecodedBlockCache();
     UpdateEventInterval();
   }
 
@@ -559,6 +584,7 @@ void SPU::DMAWrite(const u32* words, u32 word_count)
   {
     DebugAssert(m_transfer_control.mode == 2);
     std::memcpy(&m_ram[m_transfer_address], words, sizeof(u32) * word_count);
+    InvalidateDecodedBlockCache(m_transfer_address, sizeof(u32) * word_count);
     m_transfer_address = (m_transfer_address + (sizeof(u32) * word_count)) & RAM_MASK;
   }
 }
@@ -589,6 +615,7 @@ void SPU::RAMTransferWrite(u16 value)
   DebugAssert(m_transfer_control.mode == 2);
 
   std::memcpy(&m_ram[m_transfer_address], &value, sizeof(value));
+  InvalidateDecodedBlockCache(m_transfer_address, sizeof(value));
   m_transfer_address = (m_transfer_address + sizeof(value)) & RAM_MASK;
   CheckRAMIRQ(m_transfer_address);
 }
@@ -606,18 +633,51 @@ void SPU::CheckRAMIRQ(u32 address)
   }
 }
 
-void SPU::WriteToCaptureBuffer(u32 index, s16 value)
+void SPU::CheckRAMIRQ(u32 address, u32 size)
 {
-  const u32 ram_address = (index * CAPTURE_BUFFER_SIZE_PER_CHANNEL) | ZeroExtend16(m_capture_buffer_position);
-  // Log_DebugPrintf("write to capture buffer %u (0x%08X) <- 0x%04X", index, ram_address, u16(value));
-  std::memcpy(&m_ram[ram_address], &value, sizeof(value));
-  CheckRAMIRQ(ram_address);
+  if (!m_SPUCNT.irq9_enable)
+    return;
+
+  const u32 irq_address = ZeroExtend32(m_irq_address) * 8;
+  if (irq_address >= address && irq_address < (address + size))
+  {
+    Log_DebugPrintf("SPU IRQ at address 0x%08X", irq_address);
+    m_SPUSTAT.irq9_flag = true;
+    m_interrupt_controller->InterruptRequest(InterruptController::IRQ::SPU);
+  }
 }
 
-void SPU::IncrementCaptureBufferPosition()
+void SPU::FlushCaptureBuffers()
 {
-  m_capture_buffer_position += sizeof(s16);
-  m_capture_buffer_position %= CAPTURE_BUFFER_SIZE_PER_CHANNEL;
+  const u32 frames = m_capture_block_frames;
+  if (frames == 0)
+    return;
+
+  m_capture_block_frames = 0;
+
+  for (u32 index = 0; index < NUM_CAPTURE_BUFFERS; index++)
+  {
+    const s16* values = m_capture_block[index].data();
+    u32 position = m_capture_buffer_position;
+    u32 remaining = frames;
+    while (remaining > 0)
+    {
+      // split at the end of the capture buffer, it wraps around
+      const u32 ram_address = (index * CAPTURE_BUFFER_SIZE_PER_CHANNEL) | position;
+      const u32 count = std::min<u32>(remaining, (CAPTURE_BUFFER_SIZE_PER_CHANNEL - position) / sizeof(s16));
+      const u32 size = count * sizeof(s16);
+      std::memcpy(&m_ram[ram_address], values, size);
+      InvalidateDecodedBlockCache(ram_address, size);
+      CheckRAMIRQ(ram_address, size);
+
+      values += count;
+      remaining -= count;
+      position = (position + size) % CAPTURE_BUFFER_SIZE_PER_CHANNEL;
+    }
+  }
+
+  m_capture_buffer_position =
+    static_cast<u16>((m_capture_buffer_position + frames * sizeof(s16)) % CAPTURE_BUFFER_SIZE_PER_CHANNEL);
   m_SPUSTAT.second_half_capture_buffer = m_capture_buffer_position >= (CAPTURE_BUFFER_SIZE_PER_CHANNEL / 2);
 }
 
@@ -628,27 +688,60 @@ void SPU::Execute(TickCount ticks)
   u32 remaining_frames = static_cast<u32>((ticks + m_ticks_carry) / SYSCLK_TICKS_PER_SPU_TICK);
   m_ticks_carry = (ticks + m_ticks_carry) % SYSCLK_TICKS_PER_SPU_TICK;
 
-  while (remaining_frames > 0)
+  // Voices can only be keyed on by register writes, which execute any pending samples first. So the set of voices
+  // which can produce samples can't grow for the duration of this call, and silent voices can be skipped entirely.
+  // The same applies to the volumes, so they can be looked up once here.
+  u32 active_voices = 0;
+  if (m_SPUCNT.enable)
   {
-    AudioStream* const output_stream = m_system->GetHostInterface()->GetAudioStream();
-    s16* output_frame;
-    u32 output_frame_space;
-    output_stream->BeginWrite(&output_frame, &output_frame_space);
+    for (u32 i = 0; i < NUM_VOICES; i++)
+    {
+      Voice& voice = m_voices[i];
+      m_voice_volumes_left[i] = voice.regs.volume_left.GetVolume();
+      m_voice_volumes_right[i] = voice.regs.volume_right.GetVolume();
+      if (voice.IsOn())
+        active_voices |= (u32(1) << i);
+      else
+        m_voice_amplitudes[i] = 0;
+    }
+  }
+
+  const s16 main_volume_left = m_main_volume_left.GetVolume();
+  const s16 main_volume_right = m_main_volume_right.GetVolume();
+  AudioStream* const output_stream = m_system->GetHostInterface()->GetAudioStream();
 
-    const u32 frames_in_this_batch = std::min(remaining_frames, output_frame_space);
-    for (u32 i = 0; i < frames_in_this_batch; i++)
+  // Samples are generated a block at a time into a local buffer, so the output stream only has to be locked while
+  // the block is copied in, not for the whole time we're mixing.
+  std::array<s16, MIX_BLOCK_FRAMES * 2> output_block;
+  while (remaining_frames > 0)
+  {
+    const u32 frames_in_this_block = std::min(remaining_frames, MIX_BLOCK_FRAMES);
+    s16* output_frame = output_block.data();
+    for (u32 i = 0; i < frames_in_this_block; i++)
     {
       s32 left_sum = 0;
       s32 right_sum = 0;
       if (m_SPUCNT.enable)
       {
+        // Voices have to be sampled in order, as pitch modulation uses the previous voice's amplitude.
         for (u32 voice = 0; voice < NUM_VOICES; voice++)
         {
-          const auto [left, right] = SampleVoice(voice);
-          left_sum += left;
-          right_sum += right;
+          if (!(active_voices & (u32(1) << voice)))
+            continue;
+
+          if (!m_voices[voice].IsOn())
+          {
+            // voice was switched off in the last frame
+            m_voice_amplitudes[voice] = 0;
+            active_voices &= ~(u32(1) << voice);
+            continue;
+          }
+
+          SampleVoice(voice);
         }
 
+        std::tie(left_sum, right_sum) = MixVoices();
+
         if (!m_SPUCNT.mute_n)
         {
           left_sum = 0;
@@ -676,19 +769,21 @@ void SPU::Execute(TickCount ticks)
       }
 
       // Apply main volume before clamping.
-      *(output_frame++) = Clamp16(ApplyVolume(left_sum, m_main_volume_left.GetVolume()));
-      *(output_frame++) = Clamp16(ApplyVolume(right_sum, m_main_volume_right.GetVolume()));
-
-      // Write to capture buffers.
-      WriteToCaptureBuffer(0, cd_audio_left);
-      WriteToCaptureBuffer(1, cd_audio_right);
-      WriteToCaptureBuffer(2, Clamp16(m_voices[1].last_amplitude));
-      WriteToCaptureBuffer(3, Clamp16(m_voices[3].last_amplitude));
-      IncrementCaptureBufferPosition();
+      *(output_frame++) = Clamp16(ApplyVolume(left_sum, main_volume_left));
+      *(output_frame++) = Clamp16(ApplyVolume(right_sum, main_volume_right));
+
+      // Queue writes to capture buffers.
+      const u32 capture_index = m_capture_block_frames++;
+      m_capture_block[0][capture_index] = cd_audio_left;
+      m_capture_block[1][capture_index] = cd_audio_right;
+      m_capture_block[2][capture_index] = Clamp16(m_voice_amplitudes[1]);
+      m_capture_block[3][capture_index] = Clamp16(m_voice_amplitudes[3]);
     }
 
-    output_stream->EndWrite(frames_in_this_batch);
-    remaining_frames -= frames_in_this_batch;
+    FlushCaptureBuffers();
+    if (!m_audio_output_muted)
+      output_stream->WriteFrames(output_block.data(), frames_in_this_block);
+    remaining_frames -= frames_in_this_block;
   }
 }
 
@@ -871,6 +966,18 @@ void SPU::Voice::DecodeBlock(const ADPCMBlock& block)
   current_block_flags.bits = block.flags.bits;
 }
 
+void SPU::Voice::LoadDecodedBlock(const DecodedADPCMBlock& block)
+{
+  // store samples needed for interpolation
+  previous_block_last_samples[2] = current_block_samples[NUM_SAMPLES_PER_ADPCM_BLOCK - 1];
+  previous_block_last_samples[1] = current_block_samples[NUM_SAMPLES_PER_ADPCM_BLOCK - 2];
+  previous_block_last_samples[0] = current_block_samples[NUM_SAMPLES_PER_ADPCM_BLOCK - 3];
+
+  current_block_samples = block.samples;
+  adpcm_last_samples = block.output_last_samples;
+  current_block_flags.bits = block.flags.bits;
+}
+
 s16 SPU::Voice::SampleBlock(s32 index) const
 {
   if (index < 0)
@@ -985,20 +1092,14 @@ void SPU::ReadADPCMBlock(u16 address, ADPCMBlock* block)
   }
 }
 
-std::tuple<s32, s32> SPU::SampleVoice(u32 voice_index)
+void SPU::SampleVoice(u32 voice_index)
 {
   Voice& voice = m_voices[voice_index];
-  if (!voice.IsOn())
-  {
-    voice.last_amplitude = 0;
-    return {};
-  }
+  DebugAssert(voice.IsOn());
 
   if (!voice.has_samples)
   {
-    ADPCMBlock block;
-    ReadADPCMBlock(voice.current_address, &block);
-    voice.DecodeBlock(block);
+    LoadVoiceBlock(voice);
     voice.has_samples = true;
 
     if (voice.current_block_flags.loop_start)
@@ -1010,14 +1111,14 @@ std::tuple<s32, s32> SPU::SampleVoice(u32 voice_index)
 
   // interpolate/sample and apply ADSR volume
   const s32 amplitude = ApplyVolume(voice.Interpolate(), voice.regs.adsr_volume);
-  voice.last_amplitude = amplitude;
+  m_voice_amplitudes[voice_index] = amplitude;
   voice.TickADSR();
 
   // Pitch modulation
   u16 step = voice.regs.adpcm_sample_rate;
   if (IsPitchModulationEnabled(voice_index))
   {
-    const u32 factor = u32(std::clamp<s32>(m_voices[voice_index - 1].last_amplitude, -0x8000, 0x7FFF) + 0x8000);
+    const u32 factor = u32(std::clamp<s32>(m_voice_amplitudes[voice_index - 1], -0x8000, 0x7FFF) + 0x8000);
     step = Truncate16(step * factor) >> 15;
   }
   step = std::min<u16>(step, 0x4000);
@@ -1052,11 +1153,132 @@ std::tuple<s32, s32> SPU::SampleVoice(u32 voice_index)
       }
     }
   }
+}
+
+#if defined(CPU_X64)
+
+static ALWAYS_INLINE __m128i MultiplyLow32(__m128i a, __m128i b)
+{
+  // SSE2 has no 32-bit low multiply, but the low halves of the unsigned products are the same for signed inputs.
+  const __m128i even = _mm_mul_epu32(a, b);
+  const __m128i odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+  return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                            _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+static ALWAYS_INLINE s32 HorizontalSum32(__m128i v)
+{
+  v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+  v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(v);
+}
+
+#endif
+
+void SPU::LoadVoiceBlock(Voice& voice)
+{
+  // capture buffer writes are deferred until the end of the mix block, so make them visible to voices playing them
+  const u32 block_ram_address = (ZeroExtend32(voice.current_address) * 8) & RAM_MASK;
+  if (m_capture_block_frames > 0 &&
+      (block_ram_address < (CAPTURE_BUFFER_SIZE_PER_CHANNEL * NUM_CAPTURE_BUFFERS) ||
+       (block_ram_address + sizeof(ADPCMBlock)) > RAM_SIZE))
+  {
+    FlushCaptureBuffers();
+  }
+
+  DecodedADPCMBlock& entry = m_decoded_block_cache[GetDecodedBlockCacheIndex(voice.current_address)];
+  if (entry.valid && entry.address == voice.current_address &&
+      (entry.filter == 0 || entry.input_last_samples == voice.adpcm_last_samples))
+  {
+    // the block still has to be "read" for the purposes of the IRQ
+    CheckRAMIRQ(block_ram_address);
+    CheckRAMIRQ((block_ram_address + 8) & RAM_MASK);
+    voice.LoadDecodedBlock(entry);
+    return;
+  }
+
+  ADPCMBlock block;
+  ReadADPCMBlock(voice.current_address, &block);
+
+  entry.input_last_samples = voice.adpcm_last_samples;
+  voice.DecodeBlock(block);
+
+  entry.address = voice.current_address;
+  entry.valid = true;
+  entry.filter = block.GetFilter();
+  entry.flags.bits = block.flags.bits;
+  entry.output_last_samples = voice.adpcm_last_samples;
+  entry.samples = voice.current_block_samples;
+}
+
+void SPU::InvalidateDecodedBlockCache()
+{
+  for (DecodedADPCMBlock& entry : m_decoded_block_cache)
+    entry.valid = false;
+}
+
+void SPU::InvalidateDecodedBlockCache(u32 ram_address, u32 size)
+{
+  // Blocks start on 8-byte boundaries and are 16 bytes long, so the block starting before the range can overlap too.
+  const u32 first_address = (ram_address / 8) - 1;
+  const u32 last_address = (ram_address + size - 1) / 8;
+  const u32 count = last_address - first_address + 1;
+  if (count >= (DECODED_BLOCK_CACHE_SIZE * 2))
+  {
+    InvalidateDecodedBlockCache();
+    return;
+  }
+
+  for (u32 i = 0; i < count; i++)
+  {
+    const u16 address = Truncate16(first_address + i);
+    DecodedADPCMBlock& entry = m_decoded_block_cache[GetDecodedBlockCacheIndex(address)];
+    if (entry.address == address)
+      entry.valid = false;
+  }
+}
+
+std::tuple<s32, s32> SPU::MixVoices() const
+{
+  static_assert((NUM_VOICES % 4) == 0, "voices can be mixed four at a time");
+
+  // Each voice's amplitude has its volume applied separately before summing, with the same truncation as
+  // ApplyVolume(). Neither the product nor the sum can overflow 32 bits.
+#if defined(CPU_X64)
+  __m128i left_sum = _mm_setzero_si128();
+  __m128i right_sum = _mm_setzero_si128();
+  for (u32 i = 0; i < NUM_VOICES; i += 4)
+  {
+    const __m128i amplitude = _mm_load_si128(reinterpret_cast<const __m128i*>(&m_voice_amplitudes[i]));
+    const __m128i volume_left = _mm_load_si128(reinterpret_cast<const __m128i*>(&m_voice_volumes_left[i]));
+    const __m128i volume_right = _mm_load_si128(reinterpret_cast<const __m128i*>(&m_voice_volumes_right[i]));
+    left_sum = _mm_add_epi32(left_sum, _mm_srai_epi32(MultiplyLow32(amplitude, volume_left), 15));
+    right_sum = _mm_add_epi32(right_sum, _mm_srai_epi32(MultiplyLow32(amplitude, volume_right), 15));
+  }
+
+  return std::make_tuple(HorizontalSum32(left_sum), HorizontalSum32(right_sum));
+#elif defined(CPU_AARCH64)
+  int32x4_t left_sum = vdupq_n_s32(0);
+  int32x4_t right_sum = vdupq_n_s32(0);
+  for (u32 i = 0; i < NUM_VOICES; i += 4)
+  {
+    const int32x4_t amplitude = vld1q_s32(&m_voice_amplitudes[i]);
+    left_sum = vaddq_s32(left_sum, vshrq_n_s32(vmulq_s32(amplitude, vld1q_s32(&m_voice_volumes_left[i])), 15));
+    right_sum = vaddq_s32(right_sum, vshrq_n_s32(vmulq_s32(amplitude, vld1q_s32(&m_voice_volumes_right[i])), 15));
+  }
+
+  return std::make_tuple(static_cast<s32>(vaddvq_s32(left_sum)), static_cast<s32>(vaddvq_s32(right_sum)));
+#else
+  s32 left_sum = 0;
+  s32 right_sum = 0;
+  for (u32 i = 0; i < NUM_VOICES; i++)
+  {
+    left_sum += ApplyVolume(m_voice_amplitudes[i], static_cast<s16>(m_voice_volumes_left[i]));
+    right_sum += ApplyVolume(m_voice_amplitudes[i], static_cast<s16>(m_voice_volumes_right[i]));
+  }
 
-  // apply per-channel volume
-  const s32 left = ApplyVolume(amplitude, voice.regs.volume_left.GetVolume());
-  const s32 right = ApplyVolume(amplitude, voice.regs.volume_right.GetVolume());
-  return std::make_tuple(left, right);
+  return std::make_tuple(left_sum, right_sum);
+#endif
 }
 
 void SPU::EnsureCDAudioSpace(u32 remaining_frames)
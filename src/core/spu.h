@@ -4,6 +4,7 @@
 #include "types.h"
 #include <array>
 #include <memory>
+#include <vector>
 
 class StateWrapper;
 
@@ -20,7 +21,8 @@ public:
 
   void Initialize(System* system, DMA* dma, InterruptController* interrupt_controller);
   void Reset();
-  bool DoState(StateWrapper& sw);
+  /// If ram_copy is set, sound RAM is transferred to/from it instead of the stream.
+  bool DoState(StateWrapper& sw, std::vector<u8>* ram_copy);
 
   u16 ReadRegister(u32 offset);
   void WriteRegister(u32 offset, u16 value);
@@ -42,6 +44,9 @@ public:
   // Executes the SPU, generating any pending samples.
   void GeneratePendingSamples();
 
+  // Samples are still generated while muted, but not written to the host's audio stream.
+  void SetAudioOutputMuted(bool muted) { m_audio_output_muted = muted; }
+
 private:
   static constexpr u32 RAM_SIZE = 512 * 1024;
   static constexpr u32 RAM_MASK = RAM_SIZE - 1;
@@ -56,6 +61,9 @@ private:
   static constexpr s16 ADSR_MAX_VOLUME = 0x7FFF;
   static constexpr u32 CD_AUDIO_SAMPLE_BUFFER_SIZE = 44100 * 2;
   static constexpr u32 CAPTURE_BUFFER_SIZE_PER_CHANNEL = 0x400;
+  static constexpr u32 NUM_CAPTURE_BUFFERS = 4;
+  static constexpr u32 MIX_BLOCK_FRAMES = 64;
+  static constexpr u32 DECODED_BLOCK_CACHE_SIZE = 1024;
 
   enum class RAMTransferMode : u8
   {
@@ -205,6 +213,19 @@ private:
     u8 GetNibble(u32 index) const { return (data[index / 2] >> ((index % 2) * 4)) & 0x0F; }
   };
 
+  // Result of decoding an ADPCM block, kept so that looping samples don't have to be decoded repeatedly.
+  // The decoded samples depend on the filter history the block was decoded with, unless the block uses filter 0.
+  struct DecodedADPCMBlock
+  {
+    u16 address;
+    bool valid;
+    u8 filter;
+    ADPCMFlags flags;
+    std::array<s32, 2> input_last_samples;
+    std::array<s32, 2> output_last_samples;
+    std::array<s16, NUM_SAMPLES_PER_ADPCM_BLOCK> samples;
+  };
+
   enum class ADSRPhase : u8
   {
     Off = 0,
@@ -232,7 +253,6 @@ private:
     std::array<s16, NUM_SAMPLES_PER_ADPCM_BLOCK> current_block_samples;
     std::array<s16, 3> previous_block_last_samples;
     std::array<s32, 2> adpcm_last_samples;
-    s32 last_amplitude;
 
     ADSRPhase adsr_phase;
     ADSRTarget adsr_target;
@@ -247,6 +267,7 @@ private:
     void KeyOff();
 
     void DecodeBlock(const ADPCMBlock& block);
+    void LoadDecodedBlock(const DecodedADPCMBlock& block);
     s16 SampleBlock(s32 index) const;
     s16 Interpolate() const;
 
@@ -279,11 +300,17 @@ private:
   u16 RAMTransferRead();
   void RAMTransferWrite(u16 value);
   void CheckRAMIRQ(u32 address);
-  void WriteToCaptureBuffer(u32 index, s16 value);
-  void IncrementCaptureBufferPosition();
+  void CheckRAMIRQ(u32 address, u32 size);
+  void FlushCaptureBuffers();
 
   void ReadADPCMBlock(u16 address, ADPCMBlock* block);
-  std::tuple<s32, s32> SampleVoice(u32 voice_index);
+  void LoadVoiceBlock(Voice& voice);
+
+  static u32 GetDecodedBlockCacheIndex(u16 address) { return (address >> 1) % DECODED_BLOCK_CACHE_SIZE; }
+  void InvalidateDecodedBlockCache();
+  void InvalidateDecodedBlockCache(u32 ram_address, u32 size);
+  void SampleVoice(u32 voice_index);
+  std::tuple<s32, s32> MixVoices() const;
   void Execute(TickCount ticks);
   void UpdateEventInterval();
 
@@ -291,6 +318,7 @@ private:
   DMA* m_dma = nullptr;
   InterruptController* m_interrupt_controller = nullptr;
   std::unique_ptr<TimingEvent> m_sample_event;
+  bool m_audio_output_muted = false;
 
   SPUCNT m_SPUCNT = {};
   SPUSTAT m_SPUSTAT = {};
@@ -318,7 +346,18 @@ private:
   TickCount m_ticks_carry = 0;
 
   std::array<Voice, NUM_VOICES> m_voices{};
+
+  // Voice output state used for mixing, kept as separate arrays so that all voices can be mixed with SIMD.
+  // Voices which are off have an amplitude of zero, so they can be mixed unconditionally.
+  alignas(16) std::array<s32, NUM_VOICES> m_voice_amplitudes{};
+  alignas(16) std::array<s32, NUM_VOICES> m_voice_volumes_left{};
+  alignas(16) std::array<s32, NUM_VOICES> m_voice_volumes_right{};
   std::array<u8, RAM_SIZE> m_ram{};
+  std::array<DecodedADPCMBlock, DECODED_BLOCK_CACHE_SIZE> m_decoded_block_cache{};
+
+  // Capture buffer samples for the current mix block, written to RAM at the end of the block.
+  std::array<std::array<s16, MIX_BLOCK_FRAMES>, NUM_CAPTURE_BUFFERS> m_capture_block{};
+  u32 m_capture_block_frames = 0;
 
   InlineFIFOQueue<s16, CD_AUDIO_SAMPLE_BUFFER_SIZE> m_cd_audio_buffer;
 };
\ No newline at end of file
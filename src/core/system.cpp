@@ -65,8 +65,8 @@ bool System::RecreateGPU(GPURenderer renderer)
 {
   // save current state
   std::unique_ptr<ByteStream> state_stream = ByteStream_CreateGrowableMemoryStream();
-  StateWrapper sw(state_stream.get(), StateWrapper::Mode::Write);
-  const bool state_valid = m_gpu->DoState(sw) && DoEventsState(sw);
+  StateWrapper sw(state_stream.get(), StateWrapper::Mode::Write, SAVE_STATE_VERSION);
+  const bool state_valid = m_gpu->DoState(sw, false, nullptr) && DoEventsState(sw);
   if (!state_valid)
     Log_ErrorPrintf("Failed to save old GPU state when switching renderers");
 
@@ -82,7 +82,7 @@ bool System::RecreateGPU(GPURenderer renderer)
   {
     state_stream->SeekAbsolute(0);
     sw.SetMode(StateWrapper::Mode::Read);
-    m_gpu->DoState(sw);
+    m_gpu->DoState(sw, false, nullptr);
     DoEventsState(sw);
   }
 
@@ -120,7 +120,7 @@ bool System::Boot(const char* filename)
     else
     {
       Log_InfoPrintf("Loading CD image '%s'...", filename);
-      media = CDImage::Open(filename);
+      media = OpenCDImage(filename);
       if (!media)
       {
         m_host_interface->ReportFormattedError("Failed to load CD image '%s'", filename);
@@ -267,7 +267,7 @@ bool System::CreateGPU(GPURenderer renderer)
   return true;
 }
 
-bool System::DoState(StateWrapper& sw)
+bool System::DoState(StateWrapper& sw, bool vram_backup, SystemMemorySnapshot* memory)
 {
   if (!sw.DoMarker("System"))
     return false;
@@ -279,12 +279,13 @@ bool System::DoState(StateWrapper& sw)
   std::string media_filename = m_cdrom->GetMediaFileName();
   sw.Do(&media_filename);
 
-  if (sw.IsReading())
+  // Keep the current disc if it's the same image, rather than re-opening (and possibly preloading) it again.
+  if (sw.IsReading() && (media_filename.empty() || media_filename != m_cdrom->GetMediaFileName()))
   {
     std::unique_ptr<CDImage> media;
     if (!media_filename.empty())
     {
-      media = CDImage::Open(media_filename.c_str());
+      media = OpenCDImage(media_filename.c_str());
       if (!media)
         Log_ErrorPrintf("Failed to open CD image from save state: '%s'", media_filename.c_str());
     }
@@ -299,10 +300,7 @@ bool System::DoState(StateWrapper& sw)
   if (!sw.DoMarker("CPU") || !m_cpu->DoState(sw))
     return false;
 
-  if (sw.IsReading())
-    m_cpu_code_cache->Flush();
-
-  if (!sw.DoMarker("Bus") || !m_bus->DoState(sw))
+  if (!sw.DoMarker("Bus") || !m_bus->DoState(sw, memory ? &memory->ram : nullptr))
     return false;
 
   if (!sw.DoMarker("DMA") || !m_dma->DoState(sw))
@@ -311,7 +309,7 @@ bool System::DoState(StateWrapper& sw)
   if (!sw.DoMarker("InterruptController") || !m_interrupt_controller->DoState(sw))
     return false;
 
-  if (!sw.DoMarker("GPU") || !m_gpu->DoState(sw))
+  if (!sw.DoMarker("GPU") || !m_gpu->DoState(sw, vram_backup, memory ? &memory->vram : nullptr))
     return false;
 
   if (!sw.DoMarker("CDROM") || !m_cdrom->DoState(sw))
@@ -323,7 +321,7 @@ bool System::DoState(StateWrapper& sw)
   if (!sw.DoMarker("Timers") || !m_timers->DoState(sw))
     return false;
 
-  if (!sw.DoMarker("SPU") || !m_spu->DoState(sw))
+  if (!sw.DoMarker("SPU") || !m_spu->DoState(sw, memory ? &memory->spu_ram : nullptr))
     return false;
 
   if (!sw.DoMarker("MDEC") || !m_mdec->DoState(sw))
@@ -359,16 +357,17 @@ void System::Reset()
   ResetPerformanceCounters();
 }
 
-bool System::LoadState(ByteStream* state)
+bool System::LoadState(ByteStream* state, bool vram_backup /* = false */, SystemMemorySnapshot* memory /* = nullptr */,
+                       u32 version /* = SAVE_STATE_VERSION */)
 {
-  StateWrapper sw(state, StateWrapper::Mode::Read);
-  return DoState(sw);
+  StateWrapper sw(state, StateWrapper::Mode::Read, version);
+  return DoState(sw, vram_backup, memory);
 }
 
-bool System::SaveState(ByteStream* state)
+bool System::SaveState(ByteStream* state, bool vram_backup /* = false */, SystemMemorySnapshot* memory /* = nullptr */)
 {
-  StateWrapper sw(state, StateWrapper::Mode::Write);
-  return DoState(sw);
+  StateWrapper sw(state, StateWrapper::Mode::Write, SAVE_STATE_VERSION);
+  return DoState(sw, vram_backup, memory);
 }
 
 void System::RunFrame()
@@ -579,6 +578,19 @@ Controller* System::GetController(u32 slot) const
   return m_pad->GetController(slot);
 }
 
+void System::SetRunningAhead(bool running_ahead)
+{
+  m_running_ahead = running_ahead;
+  m_spu->SetAudioOutputMuted(running_ahead);
+
+  for (u32 i = 0; i < NUM_CONTROLLER_AND_CARD_PORTS; i++)
+  {
+    Controller* controller = m_pad->GetController(i);
+    if (controller)
+      controller->SetRunningAhead(running_ahead);
+  }
+}
+
 void System::UpdateControllers()
 {
   const Settings& settings = m_host_interface->GetSettings();
@@ -615,7 +627,7 @@ bool System::HasMedia() const
 
 bool System::InsertMedia(const char* path)
 {
-  std::unique_ptr<CDImage> image = CDImage::Open(path);
+  std::unique_ptr<CDImage> image = OpenCDImage(path);
   if (!image)
     return false;
 
@@ -629,6 +641,28 @@ void System::RemoveMedia()
   m_cdrom->RemoveMedia();
 }
 
+std::unique_ptr<CDImage> System::OpenCDImage(const char* path)
+{
+  std::unique_ptr<CDImage> image = CDImage::Open(path);
+  if (!image)
+    return {};
+
+  if (GetSettings().cdrom_load_image_to_ram)
+  {
+    std::unique_ptr<CDImage> memory_image =
+      CDImage::CreateMemoryImage(image.get(), [this](u32 progress_value, u32 progress_max) {
+        m_host_interface->ReportProgress("Preloading disc image", progress_value, progress_max);
+      });
+    if (memory_image)
+      return memory_image;
+
+    Log_WarningPrintf("Failed to preload '%s' to RAM, reading from disk instead", path);
+  }
+
+  image->SetDecompressedCacheSize(GetSettings().cdrom_chd_hunk_cache_size);
+  return image;
+}
+
 std::unique_ptr<TimingEvent> System::CreateTimingEvent(std::string name, TickCount period, TickCount interval,
                                                        TimingEventCallback callback, bool activate)
 {
@@ -1,16 +1,27 @@
 #pragma once
 #include "common/timer.h"
 #include "host_interface.h"
+#include "save_state_version.h"
 #include "timing_event.h"
 #include "types.h"
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 class ByteStream;
 class CDImage;
 class StateWrapper;
 
+/// Copies of RAM, VRAM and sound RAM, which can be kept outside of the state stream. These are always the same size,
+/// so unlike the stream, they can be compared directly against older copies.
+struct SystemMemorySnapshot
+{
+  std::vector<u8> ram;
+  std::vector<u16> vram;
+  std::vector<u8> spu_ram;
+};
+
 namespace CPU {
 class Core;
 class CodeCache;
@@ -78,8 +89,12 @@ public:
   bool Boot(const char* filename);
   void Reset();
 
-  bool LoadState(ByteStream* state);
-  bool SaveState(ByteStream* state);
+  /// Loads or saves the system state. If vram_backup is set, VRAM is kept in the GPU rather than in the stream,
+  /// see GPU::DoState(). The host uses this for run-ahead. If memory is set, the large memory regions are transferred
+  /// to/from it instead of the stream, which the host uses for rewind. version is that of the state being loaded.
+  bool LoadState(ByteStream* state, bool vram_backup = false, SystemMemorySnapshot* memory = nullptr,
+                 u32 version = SAVE_STATE_VERSION);
+  bool SaveState(ByteStream* state, bool vram_backup = false, SystemMemorySnapshot* memory = nullptr);
 
   /// Recreates the GPU component, saving/loading the state so it is preserved. Call when the GPU renderer changes.
   bool RecreateGPU(GPURenderer renderer);
@@ -92,6 +107,11 @@ public:
 
   void RunFrame();
 
+  /// Frames which are run ahead are rolled back afterwards, so anything they do which is visible outside the system,
+  /// i.e. audio, rumble and memory card writes, is suppressed while running ahead.
+  bool IsRunningAhead() const { return m_running_ahead; }
+  void SetRunningAhead(bool running_ahead);
+
   /// Adjusts the throttle frequency, i.e. how many times we should sleep per second.
   void SetThrottleFrequency(double frequency) { m_throttle_period = static_cast<s64>(1000000000.0 / frequency); }
 
@@ -123,7 +143,7 @@ public:
 private:
   System(HostInterface* host_interface);
 
-  bool DoState(StateWrapper& sw);
+  bool DoState(StateWrapper& sw, bool vram_backup, SystemMemorySnapshot* memory);
   bool CreateGPU(GPURenderer renderer);
 
   void InitializeComponents();
@@ -155,6 +175,9 @@ private:
       callback(ev);
   }
 
+  /// Opens a disc image, applying the CD-ROM settings to it.
+  std::unique_ptr<CDImage> OpenCDImage(const char* path);
+
   void UpdateRunningGame(const char* path, CDImage* image);
 
   HostInterface* m_host_interface;
@@ -181,6 +204,7 @@ private:
   bool m_running_events = false;
   bool m_events_need_sorting = false;
   bool m_frame_done = false;
+  bool m_running_ahead = false;
 
   std::string m_running_game_path;
   std::string m_running_game_code;
@@ -57,6 +57,14 @@ enum class AudioBackend : u8
   Count
 };
 
+enum class SaveStateCompression : u8
+{
+  None,
+  Deflate,
+  LZMA,
+  Count
+};
+
 enum class ControllerType
 {
   None,
@@ -1,6 +1,7 @@
 #include "consolesettingswidget.h"
 #include "settingwidgetbinder.h"
 #include <QtWidgets/QFileDialog>
+#include <algorithm>
 
 static constexpr char BIOS_IMAGE_FILTER[] = "Binary Images (*.bin);;All Files (*.*)";
 
@@ -15,6 +16,23 @@ ConsoleSettingsWidget::ConsoleSettingsWidget(QtHostInterface* host_interface, QW
   for (u32 i = 0; i < static_cast<u32>(CPUExecutionMode::Count); i++)
     m_ui.cpuExecutionMode->addItem(tr(Settings::GetCPUExecutionModeDisplayName(static_cast<CPUExecutionMode>(i))));
 
+  for (u32 i = 0; i < static_cast<u32>(SaveStateCompression::Count); i++)
+  {
+    m_ui.saveStateCompression->addItem(
+      tr(Settings::GetSaveStateCompressionDisplayName(static_cast<SaveStateCompression>(i))));
+  }
+
+  for (u32 i = 0; i <= Settings::MAX_RUN_AHEAD_FRAMES; i++)
+    m_ui.runAheadFrames->addItem(tr(Settings::GetRunAheadFramesDisplayName(i)));
+
+  // Maximum is stored as zero, but listed last.
+  for (u32 i = 1; i <= Settings::MAX_CDROM_READ_SPEEDUP; i++)
+    m_ui.cdromReadSpeedup->addItem(tr(Settings::GetCDROMReadSpeedupDisplayName(i)), QVariant(i));
+  m_ui.cdromReadSpeedup->addItem(tr(Settings::GetCDROMReadSpeedupDisplayName(0)), QVariant(0u));
+
+  m_ui.rewindSaveFrequency->setMaximum(static_cast<int>(Settings::MAX_REWIND_SAVE_FREQUENCY));
+  m_ui.rewindSaveSlots->setMaximum(static_cast<int>(Settings::MAX_REWIND_SAVE_SLOTS));
+
   SettingWidgetBinder::BindWidgetToEnumSetting(m_host_interface, m_ui.region, "Console/Region",
                                                &Settings::ParseConsoleRegionName, &Settings::GetConsoleRegionName);
   SettingWidgetBinder::BindWidgetToStringSetting(m_host_interface, m_ui.biosPath, "BIOS/Path");
@@ -24,16 +42,33 @@ ConsoleSettingsWidget::ConsoleSettingsWidget(QtHostInterface* host_interface, QW
                                                "General/SpeedLimiterEnabled");
   SettingWidgetBinder::BindWidgetToIntSetting(m_host_interface, m_ui.emulationSpeed, "General/EmulationSpeed");
   SettingWidgetBinder::BindWidgetToBoolSetting(m_host_interface, m_ui.pauseOnStart, "General/StartPaused");
+  SettingWidgetBinder::BindWidgetToEnumSetting(m_host_interface, m_ui.saveStateCompression,
+                                               "General/SaveStateCompression", &Settings::ParseSaveStateCompression,
+                                               &Settings::GetSaveStateCompressionName);
+  SettingWidgetBinder::BindWidgetToBoolSetting(m_host_interface, m_ui.enableRewind, "General/RewindEnable");
+  SettingWidgetBinder::BindWidgetToIntSetting(m_host_interface, m_ui.rewindSaveFrequency, "General/RewindFrequency");
+  SettingWidgetBinder::BindWidgetToIntSetting(m_host_interface, m_ui.rewindSaveSlots, "General/RewindSaveSlots");
+  SettingWidgetBinder::BindWidgetToIntSetting(m_host_interface, m_ui.runAheadFrames, "General/RunAheadFrames");
   SettingWidgetBinder::BindWidgetToEnumSetting(m_host_interface, m_ui.cpuExecutionMode, "CPU/ExecutionMode",
                                                &Settings::ParseCPUExecutionMode, &Settings::GetCPUExecutionModeName);
+  SettingWidgetBinder::BindWidgetToBoolSetting(m_host_interface, m_ui.cdromLoadImageToRAM, "CDROM/LoadImageToRAM");
+  SettingWidgetBinder::BindWidgetToBoolSetting(m_host_interface, m_ui.mdecUseWorkerThread, "MDEC/UseWorkerThread");
+
+  const QVariant read_speedup = m_host_interface->getSettingValue("CDROM/ReadSpeedup");
+  const int read_speedup_index = m_ui.cdromReadSpeedup->findData(read_speedup.isValid() ? read_speedup.toUInt() : 1u);
+  m_ui.cdromReadSpeedup->setCurrentIndex(std::max(read_speedup_index, 0));
+  connect(m_ui.cdromReadSpeedup, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this,
+          &ConsoleSettingsWidget::onCDROMReadSpeedupIndexChanged);
 
   connect(m_ui.biosPathBrowse, &QPushButton::pressed, this, &ConsoleSettingsWidget::onBrowseBIOSPathButtonClicked);
 
   connect(m_ui.enableSpeedLimiter, &QCheckBox::stateChanged, this,
           &ConsoleSettingsWidget::onEnableSpeedLimiterStateChanged);
   connect(m_ui.emulationSpeed, &QSlider::valueChanged, this, &ConsoleSettingsWidget::onEmulationSpeedValueChanged);
+  connect(m_ui.enableRewind, &QCheckBox::stateChanged, this, &ConsoleSettingsWidget::onEnableRewindStateChanged);
 
   onEnableSpeedLimiterStateChanged();
+  onEnableRewindStateChanged();
   onEmulationSpeedValueChanged(m_ui.emulationSpeed->value());
 }
 
@@ -56,7 +91,20 @@ void ConsoleSettingsWidget::onEnableSpeedLimiterStateChanged()
   m_ui.emulationSpeed->setDisabled(!m_ui.enableSpeedLimiter->isChecked());
 }
 
+void ConsoleSettingsWidget::onEnableRewindStateChanged()
+{
+  const bool enabled = m_ui.enableRewind->isChecked();
+  m_ui.rewindSaveFrequency->setEnabled(enabled);
+  m_ui.rewindSaveSlots->setEnabled(enabled);
+}
+
 void ConsoleSettingsWidget::onEmulationSpeedValueChanged(int value)
 {
   m_ui.emulationSpeedLabel->setText(tr("%1%").arg(value));
 }
+
+void ConsoleSettingsWidget::onCDROMReadSpeedupIndexChanged(int index)
+{
+  m_host_interface->putSettingValue("CDROM/ReadSpeedup", m_ui.cdromReadSpeedup->itemData(index).toUInt());
+  m_host_interface->applySettings();
+}
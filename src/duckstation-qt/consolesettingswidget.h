@@ -17,7 +17,9 @@ public:
 private Q_SLOTS:
   void onBrowseBIOSPathButtonClicked();
   void onEnableSpeedLimiterStateChanged();
+  void onEnableRewindStateChanged();
   void onEmulationSpeedValueChanged(int value);
+  void onCDROMReadSpeedupIndexChanged(int index);
 
 private:
   Ui::ConsoleSettingsWidget m_ui;
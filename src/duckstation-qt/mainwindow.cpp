@@ -14,8 +14,8 @@
 #include <cmath>
 
 static constexpr char DISC_IMAGE_FILTER[] =
-  "All File Types (*.bin *.img *.cue *.exe *.psexe);;Single-Track Raw Images (*.bin *.img);;Cue Sheets "
-  "(*.cue);;MAME CHD Images (*.chd);;PlayStation Executables (*.exe *.psexe)";
+  "All File Types (*.bin *.img *.cue *.chd *.zip *.exe *.psexe);;Single-Track Raw Images (*.bin *.img);;Cue Sheets "
+  "(*.cue);;MAME CHD Images (*.chd);;Zip Archives (*.zip);;PlayStation Executables (*.exe *.psexe)";
 
 MainWindow::MainWindow(QtHostInterface* host_interface) : QMainWindow(nullptr), m_host_interface(host_interface)
 {
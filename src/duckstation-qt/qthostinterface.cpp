@@ -50,6 +50,14 @@ void QtHostInterface::ReportMessage(const char* message)
   emit messageReported(QString::fromLocal8Bit(message));
 }
 
+void QtHostInterface::ReportProgress(const char* message, u32 progress_value, u32 progress_max)
+{
+  HostInterface::ReportProgress(message, progress_value, progress_max);
+
+  const u32 percent = (progress_max > 0) ? (progress_value * 100u / progress_max) : 100u;
+  emit messageReported(QStringLiteral("%1 (%2%)").arg(QString::fromLocal8Bit(message)).arg(percent));
+}
+
 void QtHostInterface::setDefaultSettings()
 {
   HostInterface::UpdateSettings([this]() { HostInterface::SetDefaultSettings(); });
@@ -227,6 +235,7 @@ void QtHostInterface::SwitchGPURenderer()
   std::unique_ptr<ByteStream> stream;
   if (m_system)
   {
+    DiscardRunAheadFrames();
     stream = ByteStream_CreateGrowableMemoryStream(nullptr, 8 * 1024);
     if (!m_system->SaveState(stream.get()) || !stream->SeekAbsolute(0))
       ReportError("Failed to save state before GPU renderer switch");
@@ -256,6 +265,9 @@ void QtHostInterface::SwitchGPURenderer()
       m_system->Reset();
     }
 
+    // Don't play anything produced while booting the new system.
+    m_audio_stream->EmptyBuffers();
+
     if (!m_paused)
     {
       m_audio_stream->PauseOutput(false);
@@ -344,6 +356,7 @@ std::vector<QtHostInterface::HotkeyInfo> QtHostInterface::getHotkeyList() const
     {QStringLiteral("FastForward"), QStringLiteral("Toggle Fast Forward"), QStringLiteral("General")},
     {QStringLiteral("Fullscreen"), QStringLiteral("Toggle Fullscreen"), QStringLiteral("General")},
     {QStringLiteral("Pause"), QStringLiteral("Toggle Pause"), QStringLiteral("General")},
+    {QStringLiteral("Rewind"), QStringLiteral("Rewind (Hold)"), QStringLiteral("General")},
     {QStringLiteral("ToggleSoftwareRendering"), QStringLiteral("Toggle Software Rendering"),
      QStringLiteral("Graphics")},
     {QStringLiteral("IncreaseResolutionScale"), QStringLiteral("Increase Resolution Scale"),
@@ -390,6 +403,8 @@ void QtHostInterface::updateHotkeyInputMap()
       pauseSystem(!m_paused);
   });
 
+  hk(QStringLiteral("Rewind"), [this](bool pressed) { SetRewinding(pressed); });
+
   hk(QStringLiteral("ToggleSoftwareRendering"), [this](bool pressed) {
     if (!pressed)
       ToggleSoftwareRendering();
@@ -590,7 +605,7 @@ void QtHostInterface::threadEntryPoint()
       continue;
     }
 
-    m_system->RunFrame();
+    RunFrame();
 
     m_system->GetGPU()->ResetGraphicsAPIState();
 
@@ -30,6 +30,7 @@ public:
 
   void ReportError(const char* message) override;
   void ReportMessage(const char* message) override;
+  void ReportProgress(const char* message, u32 progress_value, u32 progress_max) override;
 
   void setDefaultSettings();
 
@@ -60,4 +60,4 @@ void SDLAudioStream::AudioCallback(void* userdata, uint8_t* stream, int len)
   }
 }
 
-void SDLAudioStream::BufferAvailable() {}
+void SDLAudioStream::FramesAvailable() {}
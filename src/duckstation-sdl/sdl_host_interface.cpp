@@ -3,6 +3,7 @@
 #include "common/byte_stream.h"
 #include "common/log.h"
 #include "common/string_util.h"
+#include "core/cdrom.h"
 #include "core/controller.h"
 #include "core/gpu.h"
 #include "core/host_display.h"
@@ -170,6 +171,7 @@ void SDLHostInterface::SwitchGPURenderer()
   std::unique_ptr<ByteStream> stream;
   if (m_system)
   {
+    DiscardRunAheadFrames();
     stream = ByteStream_CreateGrowableMemoryStream(nullptr, 8 * 1024);
     if (!m_system->SaveState(stream.get()) || !stream->SeekAbsolute(0))
       ReportError("Failed to save state before GPU renderer switch");
@@ -197,6 +199,9 @@ void SDLHostInterface::SwitchGPURenderer()
       ReportError("Failed to load state after GPU renderer switch, resetting");
       m_system->Reset();
     }
+
+    // Don't play anything produced while booting the new system.
+    m_audio_stream->EmptyBuffers();
   }
 
   UpdateFullscreen();
@@ -418,6 +423,13 @@ void SDLHostInterface::HandleSDLKeyEvent(const SDL_Event* event)
     }
     break;
 
+    case SDL_SCANCODE_R:
+    {
+      if (!repeat)
+        SetRewinding(pressed);
+    }
+    break;
+
     case SDL_SCANCODE_HOME:
     {
       if (pressed && !repeat && m_system)
@@ -1176,6 +1188,67 @@ void SDLHostInterface::DrawSettingsWindow()
         }
 
         settings_changed |= ImGui::Checkbox("Pause On Start", &m_settings.start_paused);
+
+        if (ImGui::Checkbox("Enable Rewind", &m_settings.rewind_enable))
+        {
+          settings_changed = true;
+          if (!m_settings.rewind_enable)
+            ClearRewindStates();
+        }
+
+        ImGui::Text("Rewind Frequency:");
+        ImGui::SameLine(indent);
+
+        int rewind_save_frequency = static_cast<int>(m_settings.rewind_save_frequency);
+        if (ImGui::SliderInt("##rewind_save_frequency", &rewind_save_frequency, 1,
+                             static_cast<int>(Settings::MAX_REWIND_SAVE_FREQUENCY), "Every %d frames"))
+        {
+          m_settings.rewind_save_frequency = static_cast<u32>(std::max(rewind_save_frequency, 1));
+          settings_changed = true;
+        }
+
+        ImGui::Text("Rewind Save Slots:");
+        ImGui::SameLine(indent);
+
+        int rewind_save_slots = static_cast<int>(m_settings.rewind_save_slots);
+        if (ImGui::SliderInt("##rewind_save_slots", &rewind_save_slots, 1,
+                             static_cast<int>(Settings::MAX_REWIND_SAVE_SLOTS)))
+        {
+          m_settings.rewind_save_slots = static_cast<u32>(std::max(rewind_save_slots, 1));
+          settings_changed = true;
+        }
+
+        ImGui::Text("Run-Ahead:");
+        ImGui::SameLine(indent);
+
+        int run_ahead_frames = static_cast<int>(m_settings.run_ahead_frames);
+        if (ImGui::Combo(
+              "##run_ahead_frames", &run_ahead_frames,
+              [](void*, int index, const char** out_text) {
+                *out_text = Settings::GetRunAheadFramesDisplayName(static_cast<u32>(index));
+                return true;
+              },
+              nullptr, static_cast<int>(Settings::MAX_RUN_AHEAD_FRAMES) + 1))
+        {
+          m_settings.run_ahead_frames = static_cast<u32>(run_ahead_frames);
+          settings_changed = true;
+        }
+
+        ImGui::Text("Save State Compression:");
+        ImGui::SameLine(indent);
+
+        int compression = static_cast<int>(m_settings.save_state_compression);
+        if (ImGui::Combo(
+              "##save_state_compression", &compression,
+              [](void*, int index, const char** out_text) {
+                *out_text = Settings::GetSaveStateCompressionDisplayName(static_cast<SaveStateCompression>(index));
+                return true;
+              },
+              nullptr, static_cast<int>(SaveStateCompression::Count)))
+        {
+          m_settings.save_state_compression = static_cast<SaveStateCompression>(compression);
+          settings_changed = true;
+        }
       }
 
       ImGui::NewLine();
@@ -1203,8 +1276,47 @@ void SDLHostInterface::DrawSettingsWindow()
           settings_changed = true;
           UpdateSpeedLimiterState();
         }
+
+        if (ImGui::Checkbox("Dynamic Rate Control", &m_settings.audio_dynamic_rate_control))
+        {
+          settings_changed = true;
+          UpdateSpeedLimiterState();
+        }
+      }
+
+      ImGui::NewLine();
+      if (DrawSettingsSectionHeader("CD-ROM"))
+      {
+        ImGui::Text("Read Speedup:");
+        ImGui::SameLine(indent);
+
+        // Maximum is stored as zero, but listed last.
+        int speedup_index = (m_settings.cdrom_read_speedup == 0) ? static_cast<int>(Settings::MAX_CDROM_READ_SPEEDUP) :
+                                                                    static_cast<int>(m_settings.cdrom_read_speedup - 1);
+        if (ImGui::Combo(
+              "##cdrom_read_speedup", &speedup_index,
+              [](void*, int index, const char** out_text) {
+                const u32 speedup = (index == static_cast<int>(Settings::MAX_CDROM_READ_SPEEDUP)) ? 0u : (index + 1);
+                *out_text = Settings::GetCDROMReadSpeedupDisplayName(speedup);
+                return true;
+              },
+              nullptr, static_cast<int>(Settings::MAX_CDROM_READ_SPEEDUP) + 1))
+        {
+          m_settings.cdrom_read_speedup =
+            (speedup_index == static_cast<int>(Settings::MAX_CDROM_READ_SPEEDUP)) ? 0u : (speedup_index + 1);
+          if (m_system)
+            m_system->GetCDROM()->UpdateReadSpeed();
+
+          settings_changed = true;
+        }
+
+        settings_changed |= ImGui::Checkbox("Preload Image To RAM", &m_settings.cdrom_load_image_to_ram);
       }
 
+      ImGui::NewLine();
+      if (DrawSettingsSectionHeader("MDEC"))
+        settings_changed |= ImGui::Checkbox("Decode On Worker Thread", &m_settings.mdec_use_worker_thread);
+
       ImGui::EndTabItem();
     }
 
@@ -1233,6 +1345,7 @@ void SDLHostInterface::DrawSettingsWindow()
             settings_changed = true;
             if (m_system)
             {
+              DiscardRunAheadFrames();
               m_system->UpdateControllers();
               UpdateControllerControllerMapping();
             }
@@ -1248,7 +1361,10 @@ void SDLHostInterface::DrawSettingsWindow()
         {
           settings_changed = true;
           if (m_system)
+          {
+            DiscardRunAheadFrames();
             m_system->UpdateMemoryCards();
+          }
         }
 
         if (ImGui::Button("Eject Memory Card"))
@@ -1256,7 +1372,10 @@ void SDLHostInterface::DrawSettingsWindow()
           path_ptr->clear();
           settings_changed = true;
           if (m_system)
+          {
+            DiscardRunAheadFrames();
             m_system->UpdateMemoryCards();
+          }
         }
 
         ImGui::NewLine();
@@ -1511,6 +1630,7 @@ void SDLHostInterface::DoChangeDisc()
   if (!NFD_OpenDialog("bin,img,cue,chd,exe,psexe", nullptr, &path) || !path || std::strlen(path) == 0)
     return;
 
+  DiscardRunAheadFrames();
   if (m_system->InsertMedia(path))
     AddFormattedOSDMessage(2.0f, "Switched CD to '%s'", path);
   else
@@ -1591,7 +1711,7 @@ void SDLHostInterface::Run()
 
     if (m_system && !m_paused)
     {
-      m_system->RunFrame();
+      RunFrame();
       if (m_frame_step_request)
       {
         m_frame_step_request = false;
@@ -1626,7 +1746,7 @@ void SDLHostInterface::Run()
   // Save state on exit so it can be resumed
   if (m_system)
   {
-    if (!SaveState(RESUME_SAVESTATE_FILENAME))
+    if (!SaveState(RESUME_SAVESTATE_FILENAME) || !WaitForSaveStateWrites())
       ReportError("Saving state failed, you will not be able to resume this session.");
 
     DestroySystem();